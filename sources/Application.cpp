@@ -43,6 +43,8 @@ namespace {
 	"Press S to take a screenshot of the current view\n" +
 	"Press H to hide/show the information panels\n" +
 	"Press A to switch between computing modes\n" +
+	"Press B to toggle the bilinear approximation (perturbation mode)\n" +
+	"Press G to switch between glitch correction and rebasing (perturbation mode)\n" +
 	"Use arrow keys to move in the fractal";
 	
 	static const sf::Color lightBlue(85, 157, 254);
@@ -57,6 +59,29 @@ std::string ftostr(const T& obj)
 	return ss.str();
 }
 
+// Tiles per number representation, automatic mode only
+std::string tilesSummary(const RenderStatistics& statistics)
+{
+	if (statistics.tileColumns == 0)
+		return "";
+	
+	std::string summary = "\nTiles:";
+	for (int i = 0; i < RepresentationCount; ++i)
+		summary += std::string(" ") + MandelbrotRendererAuto::getRepresentationName(NumberRepresentation(i)) + " " + ftostr(statistics.tilesPerRepresentation[i]);
+	
+	return summary + "\nTiles escalated: " + ftostr(statistics.tileEscalations);
+}
+
+// Share of the SIMD lane iterations that moved a pixel on, SIMD engines only
+std::string laneSummary(const RenderStatistics& statistics)
+{
+	if (statistics.laneIterations == 0)
+		return "";
+	
+	return "\nLane utilization: " + ftostr(int(100 * statistics.activeLaneIterations / statistics.laneIterations)) + "%" +
+		(statistics.floatLanes ? " (float)" : "");
+}
+
 Application::Application(sf::RenderWindow& window, int argc, char** argv) :
 m_window(window),
 m_textFont(),
@@ -110,7 +135,7 @@ m_panelsAreVisible(true)
 	perfPos.y -= 15;
 	m_performancesInfoShape.setPosition(perfPos);
 	
-	int zoom_stat = m_fractalRenderer.getZoom();
+	floatexp zoom_stat = m_fractalRenderer.getZoom();
 	int resolution_stat = m_fractalRenderer.getResolution();
 	double xpos_stat = m_fractalRenderer.getNormalizedPosition().x;
 	double ypos_stat = m_fractalRenderer.getNormalizedPosition().y;
@@ -122,7 +147,9 @@ m_panelsAreVisible(true)
 		"Zoom: x" + ftostr(zoom_stat) + "\n" +
 		"Precision level: " + ftostr(resolution_stat) + "\n" +
 		"Position: " + ftostr(xpos_stat) + " ; " + ftostr(ypos_stat) +
-		"\nOpenCL mode : " + ftostr(m_fractalRenderer.getMode()) +
+		"\nRendering mode : " + m_fractalRenderer.getModeName() +
+		"\nBLA : " + ftostr(m_fractalRenderer.getPerturbationSettings().bilinearApproximation) +
+		"\nRebasing : " + ftostr(m_fractalRenderer.getPerturbationSettings().rebasing) +
 		"\nFP128 mode : " + ftostr(m_fractalRenderer.isMultiPrecision));
 	m_fractalInfoText.setPosition(10, m_window.getSize().y - m_fractalInfoText.getLocalBounds().height - 10);
 	
@@ -140,6 +167,8 @@ m_panelsAreVisible(true)
 	
 	m_actionsTable["swicth fp"] = thor::Action(sf::Keyboard::Q, thor::Action::PressOnce);
 	m_actionsTable["swicth mode"] = thor::Action(sf::Keyboard::A, thor::Action::PressOnce);
+	m_actionsTable["toggle bla"] = thor::Action(sf::Keyboard::B, thor::Action::PressOnce);
+	m_actionsTable["toggle rebasing"] = thor::Action(sf::Keyboard::G, thor::Action::PressOnce);
 	m_actionsTable["reset view"] = thor::Action(sf::Keyboard::R, thor::Action::PressOnce);
 	m_actionsTable["screenshot"] = thor::Action(sf::Keyboard::S, thor::Action::PressOnce);
 	m_actionsTable["toggle panels"] = thor::Action(sf::Keyboard::H, thor::Action::PressOnce);
@@ -158,6 +187,8 @@ m_panelsAreVisible(true)
 	
 	m_callbackSystem.connect("swicth fp", std::bind(&Application::swicthFp, this));
 	m_callbackSystem.connect("swicth mode", std::bind(&Application::swicthMode, this));
+	m_callbackSystem.connect("toggle bla", std::bind(&Application::toggleBilinearApproximation, this));
+	m_callbackSystem.connect("toggle rebasing", std::bind(&Application::toggleRebasing, this));
 	m_callbackSystem.connect("reset view", std::bind(&Application::resetView, this));
 	m_callbackSystem.connect("screenshot", std::bind(&Application::takeScreenshot, this));
 	m_callbackSystem.connect("toggle panels", std::bind(&Application::togglePanels, this));
@@ -210,7 +241,18 @@ void Application::handleEvents(void)
 
 void Application::update(void)
 {
-	m_performancesInfoText.setString("Fractal rendered in " + ftostr(m_fractalRenderer.getLastRenderingTime().asMilliseconds()) +" ms");
+	const RenderStatistics& statistics = m_fractalRenderer.getLastRenderingStatistics();
+	
+	m_performancesInfoText.setString("Fractal rendered in " + ftostr(m_fractalRenderer.getLastRenderingTime().asMilliseconds()) +" ms" +
+		"\nIterations skipped: " + ftostr(statistics.iterationsSkipped) +
+		"\nBLA table: " + ftostr(statistics.blaMemoryUsage / 1024) + " KB built in " + ftostr(statistics.blaBuildTime.asMilliseconds()) + " ms" +
+		"\nReferences: " + ftostr(statistics.referenceCount) + " for " + ftostr(statistics.glitchedPixels) + " glitched pixels" +
+		"\nRebases: " + ftostr(statistics.rebases) +
+		"\nInterior pixels: " + ftostr(statistics.interiorPixels) +
+		"\nmpf precision: " + ftostr(m_fractalRenderer.getPrecision()) + " bits" +
+		"\nmpf allocations: " + ftostr(statistics.arenaAllocations) + " from arenas, " + ftostr(statistics.heapAllocations) + " from the heap" +
+		tilesSummary(statistics) +
+		laneSummary(statistics));
 	m_performancesInfoText.setPosition(m_window.getSize().x - m_performancesInfoText.getLocalBounds().width - 10, 10);
 	
 	sf::Vector2f perfPos = m_performancesInfoText.getPosition();
@@ -232,7 +274,7 @@ void Application::update(void)
 	
 	m_fractalSprite.setTexture(m_fractalRenderer.getTexture());
 	
-	double zoom_stat = m_fractalRenderer.getZoom();
+	floatexp zoom_stat = m_fractalRenderer.getZoom();
 	int resolution_stat = m_fractalRenderer.getResolution();
 	double xpos_stat = m_fractalRenderer.getNormalizedPosition().x;
 	double ypos_stat = m_fractalRenderer.getNormalizedPosition().y;
@@ -240,7 +282,9 @@ void Application::update(void)
 		"Zoom: x" + ftostr(zoom_stat) + "\n" +
 		"Precision level: " + ftostr(resolution_stat) + "\n" +
 		"Position: " + ftostr(xpos_stat) + " ; " + ftostr(ypos_stat) +
-		"\nOpenCL mode : " + ftostr(m_fractalRenderer.getMode()) +
+		"\nRendering mode : " + m_fractalRenderer.getModeName() +
+		"\nBLA : " + ftostr(m_fractalRenderer.getPerturbationSettings().bilinearApproximation) +
+		"\nRebasing : " + ftostr(m_fractalRenderer.getPerturbationSettings().rebasing) +
 		"\nFP128 mode : " + ftostr(m_fractalRenderer.isMultiPrecision));
 }
 
@@ -264,7 +308,27 @@ void Application::draw(void)
 
 void Application::swicthMode(void)
 {
-	m_fractalRenderer.setMode(!m_fractalRenderer.getMode());
+	int mode = (m_fractalRenderer.getMode() + 1) % FractalRenderer::RenderingModeCount;
+
+	m_fractalRenderer.setMode(FractalRenderer::RenderingMode(mode));
+	m_fractalRenderer.performRendering();
+}
+
+void Application::toggleBilinearApproximation(void)
+{
+	PerturbationSettings settings = m_fractalRenderer.getPerturbationSettings();
+	settings.bilinearApproximation = !settings.bilinearApproximation;
+	
+	m_fractalRenderer.setPerturbationSettings(settings);
+	m_fractalRenderer.performRendering();
+}
+
+void Application::toggleRebasing(void)
+{
+	PerturbationSettings settings = m_fractalRenderer.getPerturbationSettings();
+	settings.rebasing = !settings.rebasing;
+	
+	m_fractalRenderer.setPerturbationSettings(settings);
 	m_fractalRenderer.performRendering();
 }
 
@@ -312,7 +376,7 @@ void Application::togglePanels(void)
 
 void Application::zoomIn(void)
 {
-	double zoom = m_fractalRenderer.getZoom();
+	floatexp zoom = m_fractalRenderer.getZoom();
 	
 	m_fractalRenderer.setZoom(zoom * 1.3);
 	m_fractalRenderer.performRendering();
@@ -320,9 +384,9 @@ void Application::zoomIn(void)
 
 void Application::zoomOut(void)
 {
-	double zoom = m_fractalRenderer.getZoom();
+	floatexp zoom = m_fractalRenderer.getZoom();
 	
-	m_fractalRenderer.setZoom(zoom * 1/1.3);
+	m_fractalRenderer.setZoom(zoom / 1.3);
 	m_fractalRenderer.performRendering();
 }
 
@@ -356,8 +420,8 @@ void Application::decreaseResolution(void)
 void Application::move(Direction aDirection)
 {
 	Vector2lf position = m_fractalRenderer.getNormalizedPosition();
-	double zoom = m_fractalRenderer.getZoom();
-	double offset = .1 / zoom;
+	floatexp zoom = m_fractalRenderer.getZoom();
+	double offset = (floatexp(.1) / zoom).toDouble();
 	
 	switch (aDirection) {
 		case Left:	position.x -= offset;	break;
@@ -74,6 +74,8 @@ private:
 
 	void swicthFp(void);
 	void swicthMode(void);
+	void toggleBilinearApproximation(void);
+	void toggleRebasing(void);
 	void terminate(void);
 	void resetView(void);
 	void takeScreenshot(void);
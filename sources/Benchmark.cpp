@@ -0,0 +1,510 @@
+/*
+ *  Benchmark.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "Benchmark.hpp"
+#include "Renderer/CoordinateGenerator.hpp"
+#include "Renderer/MandelbrotRendererFixedPoint.hpp"
+#include "Real/FPRealConversion.hpp"
+#include "Real/mpfreal_fixed.hpp"
+#include <iostream>
+
+namespace
+{
+	// Iterations timed for each variant, repeating the orbit if it escapes
+	const unsigned timedIterations = 200000;
+	
+	// mpf calls per iteration of the hand written loop: 3 products, a
+	// product by 2, 4 additions, a comparison and a copy
+	const int handWrittenOperations = 10;
+	
+	// The mpf iteration as the renderer wrote it before expression templates
+	unsigned iterateHandWritten(const mpfreal& cx, const mpfreal& cy, unsigned maxIteration)
+	{
+		mpfreal result, localTmp, localTmp2, zx, zy, const2;
+		const2 = 2.0;
+		zx = cx;
+		zy = cy;
+		
+		unsigned count;
+		for (count = 0; count < maxIteration; ++count)
+		{
+			mpf_mul(*localTmp, *zx, *zx);
+			mpf_mul(*localTmp2, *zy, *zy);
+			mpf_add(*result, *localTmp, *localTmp2);
+			
+			if (mpf_cmp_d(*result, 4.0) > 0)
+				break;
+			
+			mpf_sub(*result, *localTmp, *localTmp2);
+			mpf_add(*localTmp2, *result, *cx);
+			mpf_mul(*localTmp, *zx, *const2);
+			mpf_mul(*result, *localTmp, *zy);
+			mpf_add(*zy, *result, *cy);
+			zx = localTmp2;
+		}
+		return count;
+	}
+	
+	template <typename E>
+	int operations(const E&)
+	{
+		return mpfexpr::Traits<E>::node::operations;
+	}
+	
+	// Same iteration as the renderer writes it now, returns the mpf
+	// calls it takes through operationCount
+	template <typename Real>
+	unsigned iterateExpressions(const mpfreal& cx, const mpfreal& cy, unsigned maxIteration, int& operationCount)
+	{
+		Real zx, zy, x2, y2;
+		zx = cx;
+		zy = cy;
+		
+		// The comparison is one more call
+		operationCount = operations(zx * zx) + operations(zy * zy) + operations(x2 + y2) + 1 +
+						 operations(mul2k(zx * zy, 1) + cy) + operations(x2 - y2 + cx);
+		
+		unsigned count;
+		for (count = 0; count < maxIteration; ++count)
+		{
+			x2 = zx * zx;
+			y2 = zy * zy;
+			
+			if (x2 + y2 > 4)
+				break;
+			
+			zy = mul2k(zx * zy, 1) + cy;
+			zx = x2 - y2 + cx;
+		}
+		return count;
+	}
+	
+	void printIterationTime(const std::string& label, int operationCount, unsigned iterations, sf::Time elapsed)
+	{
+		std::cout << label << ": " << operationCount << " mpf calls, "
+				  << (double)elapsed.asMicroseconds() * 1000.0 / iterations << " ns per iteration" << std::endl;
+	}
+	
+	double nanosecondsPerIteration(unsigned iterations, sf::Time elapsed)
+	{
+		return (double)elapsed.asMicroseconds() * 1000.0 / iterations;
+	}
+	
+	// Times the batch kernels the CPU runs on copies of the pixel
+	// (cx, cy), against SCALAR nanoseconds per iteration
+	template <int N>
+	void timeBatchKernels(const FPReal<N, MandelbrotRendererFixedPoint::Limb>& cx,
+						  const FPReal<N, MandelbrotRendererFixedPoint::Limb>& cy, int resolution, double scalar)
+	{
+		static const char* const names[] = { "scalar", "AVX2", "AVX-512", "IFMA" };
+		const unsigned batch = 8;
+		
+		std::vector<FPReal<N, MandelbrotRendererFixedPoint::Limb> > pixels(batch, cx);
+		std::vector<int> counts(batch);
+		
+		for (int kernel = MandelbrotRendererFixedPoint::AVX2Kernel; kernel <= MandelbrotRendererFixedPoint::batchKernel(); ++kernel)
+		{
+			unsigned iterations = 0;
+			sf::Clock timer;
+			while (iterations < timedIterations)
+			{
+				MandelbrotRendererFixedPoint::iterateBatch(MandelbrotRendererFixedPoint::BatchKernel(kernel),
+														   &pixels[0], batch, cy, resolution, &counts[0]);
+				iterations += batch * (1 + counts[0]);
+			}
+			const double batchTime = nanosecondsPerIteration(iterations, timer.getElapsedTime());
+			
+			std::cout << "    " << names[kernel] << " batch: " << batchTime << " ns per iteration (x"
+					  << scalar / batchTime << ")" << std::endl;
+		}
+	}
+	
+	// Times the iteration at the center of the frame in FPReal<N> and in
+	// mpf holding as many fractional bits, then moves on to N + 1
+	template <int N>
+	struct FixedPointTimer
+	{
+		typedef FPReal<N, MandelbrotRendererFixedPoint::Limb> Real;
+		
+		static void run(const Configuration& conf, unsigned width, unsigned height)
+		{
+			const unsigned long bits = Real::WordBits * (N - 1);
+			mpf_set_default_prec(bits);
+			
+			mpfreal zoom, posx, posy;
+			zoom = conf.zoom;
+			posx = (double)conf.x;
+			posy = (double)conf.y;
+			
+			CoordinateGenerator coordinates;
+			coordinates.compute(width, height, zoom, posx, posy);
+			
+			const mpfreal& cx = coordinates.getX(width / 2);
+			const mpfreal& cy = coordinates.getY(height / 2);
+			int operationCount = 0;
+			
+			unsigned iterations = 0;
+			sf::Clock timer;
+			while (iterations < timedIterations)
+				iterations += 1 + iterateExpressions<mpfreal>(cx, cy, conf.resolution, operationCount);
+			const double multiPrecision = nanosecondsPerIteration(iterations, timer.getElapsedTime());
+			
+			Real fx, fy;
+			toFPReal(fx, *cx);
+			toFPReal(fy, *cy);
+			
+			iterations = 0;
+			timer.restart();
+			while (iterations < timedIterations)
+				iterations += 1 + MandelbrotRendererFixedPoint::iterate(fx, fy, conf.resolution);
+			const double fixedPoint = nanosecondsPerIteration(iterations, timer.getElapsedTime());
+			
+			std::cout << "  " << N << " words, " << bits << " bits: mpf " << multiPrecision << " ns, fixed point "
+					  << fixedPoint << " ns per iteration (x" << multiPrecision / fixedPoint << ")" << std::endl;
+			
+			if (N <= MandelbrotRendererFixedPoint::MaxBatchWords)
+				timeBatchKernels(fx, fy, conf.resolution, fixedPoint);
+			
+			FixedPointTimer<N + 1>::run(conf, width, height);
+		}
+	};
+	
+	template <>
+	struct FixedPointTimer<MandelbrotRendererFixedPoint::MaxWords + 1>
+	{
+		static void run(const Configuration&, unsigned, unsigned) {}
+	};
+	
+	const int timedOperations = 1000000;
+	
+	// Nanoseconds per call of each FPReal<N, Word> operation, on
+	// dependency chains the compiler cannot hoist out of the loops
+	template <int N, typename Word>
+	void timeFixedPointOperations(double times[5])
+	{
+		typedef FPReal<N, Word> Real;
+		const Real a("0.70710678118654752440084436210484903928483593768847403658833986899536623923105351942519376716"); // 1 / sqrt(2)
+		const Real b("1.41421356237309504880168872420969807856967187537694807317667973799073247846210703885038753432"); // sqrt(2)
+		const Real step("0.00000012345678912345678912345678912345678912345678912345678912345678912345678912345678912345");
+		Real x(a), y;
+		
+		sf::Clock timer;
+		for (int i = 0; i < timedOperations; ++i)
+			x.add(step);
+		times[0] = nanosecondsPerIteration(timedOperations, timer.getElapsedTime());
+		
+		timer.restart();
+		for (int i = 0; i < timedOperations; ++i)
+			x.sub(step);
+		times[1] = nanosecondsPerIteration(timedOperations, timer.getElapsedTime());
+		
+		timer.restart();
+		for (int i = 0; i < timedOperations; ++i)
+		{
+			mul(y, x, b);
+			mul(x, y, a);
+		}
+		times[2] = nanosecondsPerIteration(2 * timedOperations, timer.getElapsedTime());
+		
+		timer.restart();
+		for (int i = 0; i < timedOperations; ++i)
+		{
+			x.mul2k(1);
+			x.mul2k(-1);
+		}
+		times[3] = nanosecondsPerIteration(2 * timedOperations, timer.getElapsedTime());
+		
+		timer.restart();
+		for (int i = 0; i < timedOperations; ++i)
+		{
+			x.mul(3);
+			x.div(3);
+		}
+		times[4] = nanosecondsPerIteration(2 * timedOperations, timer.getElapsedTime());
+	}
+	
+	// Square by mul and by sqr, and x^2 - y^2 + c, plain and fused, in
+	// FPReal<N>
+	template <int N>
+	void timeFixedPointKernels()
+	{
+		typedef FPReal<N, MandelbrotRendererFixedPoint::Limb> Real;
+		const Real a("0.70710678118654752440084436210484903928483593768847403658833986899536623923105351942519376716"); // 1 / sqrt(2)
+		const Real c("-0.74364388703715870475219150611477"); // x = x^2 - a^2 + c stays bounded
+		Real x(a), y, z, x2, y2;
+		double times[4];
+		
+		// The add and sub only chain the squares
+		sf::Clock timer;
+		for (int i = 0; i < timedOperations; ++i)
+		{
+			mul(z, x, x);
+			x.add(z);
+			x.sub(z);
+		}
+		times[0] = nanosecondsPerIteration(timedOperations, timer.getElapsedTime());
+		
+		timer.restart();
+		for (int i = 0; i < timedOperations; ++i)
+		{
+			sqr(z, x);
+			x.add(z);
+			x.sub(z);
+		}
+		times[1] = nanosecondsPerIteration(timedOperations, timer.getElapsedTime());
+		
+		x = c;
+		y = a;
+		timer.restart();
+		for (int i = 0; i < timedOperations; ++i)
+		{
+			mul(x2, x, x);
+			mul(y2, y, y);
+			x = x2;
+			x.sub(y2);
+			x.add(c);
+		}
+		times[2] = nanosecondsPerIteration(timedOperations, timer.getElapsedTime());
+		
+		x = c;
+		timer.restart();
+		for (int i = 0; i < timedOperations; ++i)
+			sqrDiffAdd(x, x2, y2, x, y, c);
+		times[3] = nanosecondsPerIteration(timedOperations, timer.getElapsedTime());
+		
+		const std::streamsize precision = std::cout.precision(3);
+		std::cout << "  " << N << " words, " << Real::WordBits * (N - 1) << " bits: x * x with mul " << times[0]
+				  << " ns, with sqr " << times[1] << " ns, x^2 - y^2 + c " << times[2]
+				  << " ns, fused " << times[3] << " ns" << std::endl;
+		std::cout.precision(precision);
+	}
+	
+	// Same precision on N32 32-bit words and N64 64-bit words
+	template <int N32, int N64>
+	void compareFixedPointWords()
+	{
+		static const char* names[5] = { "add", "sub", "product", "shift", "mul/div by int" };
+		double words[5], limbs[5];
+		timeFixedPointOperations<N32, uint32>(words);
+		timeFixedPointOperations<N64, uint64>(limbs);
+		
+		const std::streamsize precision = std::cout.precision(3);
+		std::cout << "  " << 32 * (N32 - 1) << " fractional bits, " << N32 << " x 32 against " << N64 << " x 64:";
+		for (int i = 0; i < 5; ++i)
+			std::cout << " " << names[i] << " " << words[i] << " / " << limbs[i] << " ns";
+		std::cout << std::endl;
+		std::cout.precision(precision);
+	}
+}
+
+Benchmark::Benchmark(unsigned width, unsigned height) :
+m_data(NULL),
+m_width(width),
+m_height(height)
+{
+	m_data = new unsigned char[m_width * m_height * 4];
+}
+
+Benchmark::~Benchmark(void)
+{
+	delete[] m_data;
+}
+
+void Benchmark::run(const std::string& filename)
+{
+	Configuration conf;
+	conf.deserialize(filename);
+	
+	// Same mpf precision as the explorer would use for this location
+	mpf_set_default_prec(FractalRenderer::requiredPrecision(conf.zoom, m_height));
+	
+	std::cout << filename << ": zoom x" << conf.zoom << ", precision level " << conf.resolution
+			  << ", " << mpf_get_default_prec() << " mpf bits" << std::endl;
+	
+	PerturbationSettings plain;
+	plain.seriesApproximation = false;
+	run(conf, FractalRenderer::PerturbationMode, plain, "perturbation");
+	
+	PerturbationSettings series;
+	run(conf, FractalRenderer::PerturbationMode, series, "perturbation + SA");
+	
+	PerturbationSettings bla;
+	bla.bilinearApproximation = true;
+	run(conf, FractalRenderer::PerturbationMode, bla, "perturbation + SA + BLA");
+	
+	PerturbationSettings rebasing;
+	rebasing.rebasing = true;
+	run(conf, FractalRenderer::PerturbationMode, rebasing, "perturbation + SA + rebasing");
+	
+	rebasing.bilinearApproximation = true;
+	run(conf, FractalRenderer::PerturbationMode, rebasing, "perturbation + SA + BLA + rebasing");
+	
+	run(conf, FractalRenderer::DoubleMode, PerturbationSettings(), FractalRenderer::getModeName(FractalRenderer::DoubleMode));
+	
+	run(conf, FractalRenderer::DoubleDoubleMode, PerturbationSettings(), FractalRenderer::getModeName(FractalRenderer::DoubleDoubleMode));
+	
+	run(conf, FractalRenderer::AutoMode, PerturbationSettings(), FractalRenderer::getModeName(FractalRenderer::AutoMode));
+	
+	run(conf, FractalRenderer::MultiPrecisionMode, PerturbationSettings(), FractalRenderer::getModeName(FractalRenderer::MultiPrecisionMode));
+	std::vector<unsigned char> multiPrecision(m_data, m_data + m_width * m_height * 4);
+	
+	run(conf, FractalRenderer::FixedPointMode, PerturbationSettings(), FractalRenderer::getModeName(FractalRenderer::FixedPointMode));
+	std::cout << "fixed point and mpf differ on " << _differingPixels(multiPrecision) << " pixels" << std::endl;
+	
+	// Quad-double against mpf holding the same 212 bits
+	const unsigned long defaultPrecision = mpf_get_default_prec();
+	mpf_set_default_prec(212);
+	
+	run(conf, FractalRenderer::QuadDoubleMode, PerturbationSettings(), FractalRenderer::getModeName(FractalRenderer::QuadDoubleMode));
+	std::vector<unsigned char> quadDouble(m_data, m_data + m_width * m_height * 4);
+	
+	run(conf, FractalRenderer::MultiPrecisionMode, PerturbationSettings(), std::string(FractalRenderer::getModeName(FractalRenderer::MultiPrecisionMode)) + ", 212 bits");
+	std::cout << "quad-double and mpf differ on " << _differingPixels(quadDouble) << " pixels" << std::endl;
+	
+	mpf_set_default_prec(defaultPrecision);
+	
+	runIteration(conf);
+	runFixedPoint(conf);
+}
+
+void Benchmark::runFixedPoint(const Configuration& conf)
+{
+	const unsigned long defaultPrecision = mpf_get_default_prec();
+	
+	std::cout << "fixed point against mpf at equal precision:" << std::endl;
+	FixedPointTimer<MandelbrotRendererFixedPoint::MinWords>::run(conf, m_width, m_height);
+	
+	mpf_set_default_prec(defaultPrecision);
+}
+
+void Benchmark::runFixedPointOperations(void)
+{
+	std::cout << "FPReal operations, 32-bit words / 64-bit limbs:" << std::endl;
+	compareFixedPointWords<3, 2>();
+	compareFixedPointWords<5, 3>();
+	compareFixedPointWords<9, 5>();
+	compareFixedPointWords<15, 8>();
+	
+	std::cout << "FPReal kernels:" << std::endl;
+	timeFixedPointKernels<2>();
+	timeFixedPointKernels<3>();
+	timeFixedPointKernels<4>();
+	timeFixedPointKernels<5>();
+	timeFixedPointKernels<6>();
+	timeFixedPointKernels<7>();
+	timeFixedPointKernels<8>();
+	timeFixedPointKernels<9>();
+}
+
+void Benchmark::runIteration(const Configuration& conf)
+{
+	mpfreal zoom, posx, posy;
+	
+	zoom = conf.zoom;
+	posx = (double)conf.x;
+	posy = (double)conf.y;
+	
+	CoordinateGenerator coordinates;
+	coordinates.compute(m_width, m_height, zoom, posx, posy);
+	
+	const mpfreal& cx = coordinates.getX(m_width / 2);
+	const mpfreal& cy = coordinates.getY(m_height / 2);
+	int operationCount = 0;
+	
+	unsigned iterations = 0;
+	sf::Clock timer;
+	while (iterations < timedIterations)
+		iterations += 1 + iterateHandWritten(cx, cy, conf.resolution);
+	printIterationTime("mpf iteration, hand written", handWrittenOperations, iterations, timer.getElapsedTime());
+	
+	iterations = 0;
+	timer.restart();
+	while (iterations < timedIterations)
+		iterations += 1 + iterateExpressions<mpfreal>(cx, cy, conf.resolution, operationCount);
+	printIterationTime("mpf iteration, expression templates", operationCount, iterations, timer.getElapsedTime());
+	
+	if (mpfreal_fixed<1024>::fits())
+	{
+		iterations = 0;
+		timer.restart();
+		while (iterations < timedIterations)
+			iterations += 1 + iterateExpressions<mpfreal_fixed<1024> >(cx, cy, conf.resolution, operationCount);
+		printIterationTime("mpf iteration, expression templates on inline limbs", operationCount, iterations, timer.getElapsedTime());
+	}
+}
+
+unsigned Benchmark::_differingPixels(const std::vector<unsigned char>& image) const
+{
+	unsigned count = 0;
+	for (unsigned i = 0; i < m_width * m_height; ++i)
+	{
+		if (m_data[i * 4] != image[i * 4])
+			++count;
+	}
+	return count;
+}
+
+void Benchmark::run(const Configuration& conf, FractalRenderer::RenderingMode mode,
+					const PerturbationSettings& settings, const std::string& label)
+{
+	IRenderer* renderer = FractalRenderer::createRenderer(mode, settings);
+	
+	mpfreal zoom, posx, posy;
+	
+	zoom = conf.zoom;
+	posx = (double)conf.x;
+	posy = (double)conf.y;
+	
+	sf::Clock timer;
+	renderer->render(m_data, m_width, m_height, zoom, conf.resolution, posx, posy);
+	sf::Time elapsed = timer.getElapsedTime();
+	
+	const RenderStatistics& statistics = renderer->getStatistics();
+	
+	std::cout << "\xd" << label << ": " << elapsed.asMilliseconds() << " ms"
+			  << ", skipped " << statistics.iterationsSkipped
+			  << ", references " << statistics.referenceCount
+			  << ", glitched " << statistics.glitchedPixels
+			  << " (" << statistics.unresolvedGlitches << " unresolved)"
+			  << ", rebases " << statistics.rebases
+			  << ", interior " << statistics.interiorPixels
+			  << ", mpf allocations " << statistics.arenaAllocations << " arena / " << statistics.heapAllocations << " heap"
+			  << std::endl;
+	
+	if (statistics.laneIterations > 0)
+		std::cout << "  lane utilization " << 100.0 * statistics.activeLaneIterations / statistics.laneIterations << "%"
+				  << (statistics.floatLanes ? " (float)" : "") << std::endl;
+	
+	if (statistics.tileColumns > 0)
+	{
+		std::cout << "  tiles:";
+		for (int i = 0; i < RepresentationCount; ++i)
+			std::cout << " " << MandelbrotRendererAuto::getRepresentationName(NumberRepresentation(i)) << " " << statistics.tilesPerRepresentation[i];
+		std::cout << ", escalated " << statistics.tileEscalations << std::endl;
+	}
+	
+	delete renderer;
+}
@@ -0,0 +1,68 @@
+/*
+ *  Benchmark.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <string>
+#include <vector>
+#include "FractalRenderer.hpp"
+#include "Configuration.hpp"
+
+// Renders saved locations off screen with every CPU engine and prints
+// the rendering time and statistics of each frame.
+class Benchmark {
+public:
+	Benchmark(unsigned width, unsigned height);
+	~Benchmark(void);
+	
+	// Run every engine on the location saved in filename
+	void run(const std::string& filename);
+	
+	void run(const Configuration& conf, FractalRenderer::RenderingMode mode,
+			 const PerturbationSettings& settings, const std::string& label);
+	
+	// Time one mpf iteration at the center of the location, hand written
+	// and with expression templates
+	void runIteration(const Configuration& conf);
+	
+	// Time the iteration in every FPReal<N> against mpf with as many bits
+	void runFixedPoint(const Configuration& conf);
+	
+	// Time each FPReal operation on 32-bit words against 64-bit limbs,
+	// then the squaring kernels for every number of limbs
+	void runFixedPointOperations(void);
+	
+private:
+	// Pixels of the last frame that differ from image
+	unsigned _differingPixels(const std::vector<unsigned char>& image) const;
+	
+	unsigned char *m_data;
+	unsigned m_width;
+	unsigned m_height;
+};
+
+#endif
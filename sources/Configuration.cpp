@@ -5,12 +5,15 @@
 
 void Configuration::serialize(const std::string& filename)
 {
-	unsigned int version = 1;
+	unsigned int version = 2;
 	std::ofstream file(filename.c_str(), std::ios::trunc | std::ios::binary);
 	file.write((char*)&version, 4);
 	file.write((char*)&x, sizeof(x));
 	file.write((char*)&y, sizeof(y));
-	file.write((char*)&zoom, sizeof(zoom));
+	double mantissa = zoom.mantissa();
+	floatexp::exp_t exponent = zoom.exponent();
+	file.write((char*)&mantissa, sizeof(mantissa));
+	file.write((char*)&exponent, sizeof(exponent));
 	file.write((char*)&resolution, sizeof(resolution));
 	file.close();
 }
@@ -22,7 +25,23 @@ void Configuration::deserialize(const std::string& filename)
 	file.read((char*)&version, 4);
 	file.read((char*)&x, sizeof(x));
 	file.read((char*)&y, sizeof(y));
-	file.read((char*)&zoom, sizeof(zoom));
+	
+	if (version < 2)
+	{
+		// Version 1 stored the zoom as a plain long double
+		long double oldZoom = 1.0;
+		file.read((char*)&oldZoom, sizeof(oldZoom));
+		zoom = (double)oldZoom;
+	}
+	else
+	{
+		double mantissa = 1.0;
+		floatexp::exp_t exponent = 0;
+		file.read((char*)&mantissa, sizeof(mantissa));
+		file.read((char*)&exponent, sizeof(exponent));
+		zoom = floatexp(mantissa, exponent);
+	}
+	
 	file.read((char*)&resolution, sizeof(resolution));
 	file.close();
 }
\ No newline at end of file
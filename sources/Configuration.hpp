@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include "Real/floatexp.hpp"
 
 class Configuration
 {
@@ -10,7 +11,7 @@ public:
 	void deserialize(const std::string& filename);
 
 	long double x,y;
-	long double zoom;
+	floatexp zoom;
 	unsigned int resolution;
 
 private:
@@ -0,0 +1,125 @@
+/*
+ *  CpuFeatures.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#include "CpuFeatures.hpp"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace {
+	void cpuid(int leaf, int subleaf, unsigned registers[4])
+	{
+#ifdef _MSC_VER
+		int values[4];
+		__cpuidex(values, leaf, subleaf);
+		for (int i = 0; i < 4; ++i)
+			registers[i] = (unsigned)values[i];
+#else
+		__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+	}
+
+	// Register state the OS saves on context switches
+	unsigned long long xgetbv0(void)
+	{
+#ifdef _MSC_VER
+		return _xgetbv(0);
+#else
+		unsigned eax, edx;
+		__asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return ((unsigned long long)edx << 32) | eax;
+#endif
+	}
+
+	bool detectAVX2(void)
+	{
+		unsigned registers[4]; // eax, ebx, ecx, edx
+
+		cpuid(0, 0, registers);
+		if (registers[0] < 7)
+			return false;
+
+		cpuid(1, 0, registers);
+		const bool fma = (registers[2] & (1u << 12)) != 0;
+		const bool osxsave = (registers[2] & (1u << 27)) != 0;
+		const bool avx = (registers[2] & (1u << 28)) != 0;
+
+		if (!fma || !osxsave || !avx)
+			return false;
+
+		// XMM and YMM state
+		if ((xgetbv0() & 6) != 6)
+			return false;
+
+		cpuid(7, 0, registers);
+		return (registers[1] & (1u << 5)) != 0;
+	}
+
+	bool detectAVX512(void)
+	{
+		if (!detectAVX2())
+			return false;
+
+		// Opmask, upper ZMM0-15 and ZMM16-31 state on top of XMM and YMM
+		if ((xgetbv0() & 0xE6) != 0xE6)
+			return false;
+
+		unsigned registers[4];
+		cpuid(7, 0, registers);
+		return (registers[1] & (1u << 16)) != 0;
+	}
+
+	bool detectAVX512IFMA(void)
+	{
+		if (!detectAVX512())
+			return false;
+
+		unsigned registers[4];
+		cpuid(7, 0, registers);
+		return (registers[1] & (1u << 21)) != 0;
+	}
+}
+
+bool CpuFeatures::hasAVX2(void)
+{
+	static const bool available = detectAVX2();
+	return available;
+}
+
+bool CpuFeatures::hasAVX512(void)
+{
+	static const bool available = detectAVX512();
+	return available;
+}
+
+bool CpuFeatures::hasAVX512IFMA(void)
+{
+	static const bool available = detectAVX512IFMA();
+	return available;
+}
@@ -0,0 +1,45 @@
+/*
+ *  CpuFeatures.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ *
+ */
+
+#ifndef CPU_FEATURES_HPP
+#define CPU_FEATURES_HPP
+
+// Instruction sets the running CPU and OS support. Code built with wider
+// instruction sets than the project default lives in its own files and
+// is only called once these said yes.
+class CpuFeatures {
+public:
+	// AVX2 and FMA3, with the OS saving the YMM registers
+	static bool hasAVX2(void);
+
+	// AVX-512 foundation, with the OS saving the ZMM and mask registers
+	static bool hasAVX512(void);
+
+	// AVX-512 IFMA, the 52-bit integer multiply-add
+	static bool hasAVX512IFMA(void);
+};
+
+#endif
@@ -30,6 +30,10 @@
 #include "FractalRenderer.hpp"
 #include "Renderer/MandelbrotRendererCL.hpp"
 #include "Renderer/MandelbrotRenderer.hpp"
+#include "Renderer/MandelbrotRendererDouble.hpp"
+#include "Renderer/MandelbrotRendererDoubleDouble.hpp"
+#include "Renderer/MandelbrotRendererQuadDouble.hpp"
+#include "Renderer/MandelbrotRendererFixedPoint.hpp"
 #include <iostream>
 
 
@@ -42,7 +46,10 @@ m_resolution(100),
 m_image_x(width),
 m_image_y(heigth),
 m_lastRenderingTime(sf::Time::Zero),
-m_mode(true),
+m_mode(AutoMode),
+m_precision(0),
+m_perturbationSettings(),
+m_lastRenderingStatistics(),
 isMultiPrecision(false)
 {
 	m_data = new unsigned char[m_image_x * m_image_y * 4];
@@ -75,11 +82,12 @@ void FractalRenderer::_performRendering(void)
 	isRendering = true;
 	sf::Clock timer;
 
-	IRenderer* renderer = nullptr;
-	if(m_mode)
-		renderer = new MandelbrotRendererCL;
-	else
-		renderer = new MandelbrotRenderer;
+	// Every mpf of the frame, reference orbits and coordinates included,
+	// is created after this and follows the zoom
+	m_precision = requiredPrecision(m_scale, m_image_y);
+	mpf_set_default_prec(m_precision);
+
+	IRenderer* renderer = createRenderer(m_mode, m_perturbationSettings);
 
 	mpfreal zoom, posx, posy;
 
@@ -88,6 +96,7 @@ void FractalRenderer::_performRendering(void)
 	posy = (double)m_normalizedPosition.y;
 
 	renderer->render(m_data, m_image_x, m_image_y, zoom, m_resolution, posx, posy);
+	m_lastRenderingStatistics = renderer->getStatistics();
 
 	delete renderer;
 
@@ -98,12 +107,12 @@ void FractalRenderer::_performRendering(void)
 	isRendering = false;
 }
 
-void FractalRenderer::setZoom(double zoom)
+void FractalRenderer::setZoom(const floatexp& zoom)
 {
 	m_scale = zoom;
 }
 
-void FractalRenderer::setMode(bool mode)
+void FractalRenderer::setMode(RenderingMode mode)
 {
 	m_mode = mode;
 }
@@ -120,17 +129,52 @@ void FractalRenderer::setResolution(int resolution)
 }
 
 
-double FractalRenderer::getZoom(void)
+const floatexp& FractalRenderer::getZoom(void)
 {
 	return m_scale;
 }
 
 
-bool FractalRenderer::getMode() const
+FractalRenderer::RenderingMode FractalRenderer::getMode() const
 {
 	return m_mode;
 }
 
+const char* FractalRenderer::getModeName() const
+{
+	return getModeName(m_mode);
+}
+
+IRenderer* FractalRenderer::createRenderer(RenderingMode mode, const PerturbationSettings& perturbationSettings)
+{
+	switch (mode) {
+		case OpenCLMode:			return new MandelbrotRendererCL;
+		case MultiPrecisionMode:	return new MandelbrotRenderer;
+		case PerturbationMode:		return new MandelbrotRendererPerturbation(perturbationSettings);
+		case AutoMode:				return new MandelbrotRendererAuto(perturbationSettings);
+		case DoubleDoubleMode:		return new MandelbrotRendererDoubleDouble;
+		case QuadDoubleMode:		return new MandelbrotRendererQuadDouble;
+		case FixedPointMode:		return new MandelbrotRendererFixedPoint;
+		case DoubleMode:			return new MandelbrotRendererDouble;
+		default:					return new MandelbrotRendererCL;
+	}
+}
+
+const char* FractalRenderer::getModeName(RenderingMode mode)
+{
+	switch (mode) {
+		case OpenCLMode:			return "OpenCL";
+		case MultiPrecisionMode:	return "OpenMP mpf";
+		case PerturbationMode:		return "Perturbation";
+		case AutoMode:				return "Automatic";
+		case DoubleDoubleMode:		return "OpenMP double-double";
+		case QuadDoubleMode:		return "OpenMP quad-double";
+		case FixedPointMode:		return "OpenMP fixed point";
+		case DoubleMode:			return "OpenMP double";
+		default:					return "Unknown";
+	}
+}
+
 const Vector2lf& FractalRenderer::getNormalizedPosition(void)
 {
 	return m_normalizedPosition;
@@ -147,6 +191,38 @@ const sf::Time& FractalRenderer::getLastRenderingTime(void)
 	return m_lastRenderingTime;
 }
 
+const RenderStatistics& FractalRenderer::getLastRenderingStatistics(void)
+{
+	return m_lastRenderingStatistics;
+}
+
+unsigned long FractalRenderer::getPrecision(void) const
+{
+	return m_precision;
+}
+
+unsigned long FractalRenderer::requiredPrecision(const floatexp& zoom, unsigned heigth)
+{
+	// Pixels are 1 / zoom_y apart on coordinates below 4 in magnitude:
+	// telling them apart takes log2(4 * zoom_y) bits. The guard bits
+	// absorb the rounding errors the iterations amplify.
+	const unsigned long guardBits = 64;
+	const floatexp zoom_y = zoom * floatexp(heigth / 2.4);
+	const floatexp::exp_t pixelBits = zoom_y.exponent() + 1 + 2;
+
+	return (pixelBits > 0 ? (unsigned long)pixelBits : 0) + guardBits;
+}
+
+void FractalRenderer::setPerturbationSettings(const PerturbationSettings& settings)
+{
+	m_perturbationSettings = settings;
+}
+
+const PerturbationSettings& FractalRenderer::getPerturbationSettings(void) const
+{
+	return m_perturbationSettings;
+}
+
 const sf::Texture& FractalRenderer::getTexture(void)
 {
 	return m_texture;
@@ -30,26 +30,54 @@
 
 #include <SFML/Graphics.hpp>
 #include "Common.hpp"
+#include "Real/floatexp.hpp"
+#include "Renderer/MandelbrotRendererPerturbation.hpp"
+#include "Renderer/MandelbrotRendererAuto.hpp"
 
 class FractalRenderer {
 public:
+	enum RenderingMode {
+		OpenCLMode,
+		MultiPrecisionMode,
+		PerturbationMode,
+		AutoMode,
+		DoubleDoubleMode,
+		QuadDoubleMode,
+		FixedPointMode,
+		DoubleMode,
+		RenderingModeCount
+	};
+
 	FractalRenderer(unsigned width, unsigned height);
 	~FractalRenderer(void);
 	
 	void performRendering(void);
 	
-	void setZoom(double zoom);
-	void setMode(bool mode);
+	void setZoom(const floatexp& zoom);
+	void setMode(RenderingMode mode);
 	void setNormalizedPosition(Vector2lf normalizedPosition);
 	void setResolution(int resolution);
 	
-	bool getMode(void) const;
-	double getZoom(void);
+	RenderingMode getMode(void) const;
+	const char* getModeName(void) const;
+	const floatexp& getZoom(void);
 	const Vector2lf& getNormalizedPosition(void);
 	int getResolution(void);
 	const sf::Time& getLastRenderingTime(void);
+	const RenderStatistics& getLastRenderingStatistics(void);
+	unsigned long getPrecision(void) const;
+	
+	void setPerturbationSettings(const PerturbationSettings& settings);
+	const PerturbationSettings& getPerturbationSettings(void) const;
 	
 	const sf::Texture& getTexture(void);
+	
+	static IRenderer* createRenderer(RenderingMode mode, const PerturbationSettings& perturbationSettings);
+	static const char* getModeName(RenderingMode mode);
+
+	// mpf mantissa bits needed to tell apart the pixels of a heigth pixels
+	// high frame at this zoom, with guard bits for the iteration errors
+	static unsigned long requiredPrecision(const floatexp& zoom, unsigned heigth);
 
 	bool isRendering;
 	bool isMultiPrecision;
@@ -63,13 +91,17 @@ private:
 	sf::Texture m_texture;
 	
 	Vector2lf m_normalizedPosition;
-	double m_scale;
+	floatexp m_scale;
 	int m_resolution;
 	int m_image_x;
 	int m_image_y;
-	bool m_mode;
+	RenderingMode m_mode;
+	unsigned long m_precision;
+	
+	PerturbationSettings m_perturbationSettings;
 	
 	sf::Time m_lastRenderingTime;
+	RenderStatistics m_lastRenderingStatistics;
 	
 };
 
@@ -0,0 +1,53 @@
+/*
+ *  Complex.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef COMPLEX_HPP
+#define COMPLEX_HPP
+
+// Minimal complex number over any of our real types. std::complex is
+// only defined for the built-in floating point types.
+template <typename T> struct Complex
+{
+	T x;
+	T y;
+
+	Complex() : x(0), y(0) {}
+	Complex(const T& re) : x(re), y(0) {}
+	Complex(const T& re, const T& im) : x(re), y(im) {}
+
+	friend Complex operator + (const Complex& a, const Complex& b) { return Complex(a.x + b.x, a.y + b.y); }
+	friend Complex operator - (const Complex& a, const Complex& b) { return Complex(a.x - b.x, a.y - b.y); }
+	friend Complex operator * (const Complex& a, const Complex& b) { return Complex(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x); }
+	friend Complex operator * (const T& k, const Complex& a) { return Complex(k * a.x, k * a.y); }
+
+	friend Complex operator / (const Complex& a, const T& k) { return Complex(a.x / k, a.y / k); }
+
+	Complex& operator += (const Complex& a) { x = x + a.x; y = y + a.y; return *this; }
+
+	// |z|^2
+	friend T norm(const Complex& a) { return a.x * a.x + a.y * a.y; }
+};
+
+#endif
@@ -12,18 +12,21 @@
 #endif
 #include "MPBase.h"
 
-// Generic implementation of fixed-point reals stored on N 32-bit words.
+// Generic implementation of fixed-point reals stored on N words.
 // The first word is the integer part.
+// Words are 32-bit by default; uint64 selects the 64-bit limb functions
+// of MPBase, which need half the words for the same precision.
 
-template <int N> class FPReal
+template <int N, typename Word = uint32> class FPReal
 {
 public:
 
 	// Constants and types
 	static const int Size = N; // Number of words
-	static const int Log2Min = -((N-1)<<5); // Log2 of the least significant bit of a FPReal
-	static const int Log2Max = 31; // Log2 of the most significant bit of a FPReal
-	typedef uint32 word_t; // From MPBase
+	static const int WordBits = 8*sizeof(Word); // Bits per word
+	static const int Log2Min = -(N-1)*WordBits; // Log2 of the least significant bit of a FPReal
+	static const int Log2Max = WordBits-1; // Log2 of the most significant bit of a FPReal
+	typedef Word word_t; // uint32 or uint64, from MPBase
 
 	// Constructor, initialized to 0.
 	FPReal() { sign = 0; }
@@ -33,7 +36,7 @@ public:
 	FPReal(double x) { set(x); }
 	FPReal(const FPReal & x) { set(x); }
 	FPReal(const char * x) { if (!set(x)) set(0); }
-	template <int M> FPReal(const FPReal<M> & x) { set(x); }
+	template <int M> FPReal(const FPReal<M,Word> & x) { set(x); }
 
 	// = operator
 	FPReal & operator = (const FPReal & x)
@@ -56,7 +59,7 @@ public:
 	void set(double x)
 	{
 		if (x == 0) { sign = 0; return; }
-		double p = ldexp(1.0,32); // 2^32
+		double p = ldexp(1.0,WordBits); // 2^WordBits
 		if (x < 0) { x = -x; sign = -1; }
 		else sign = 1;
 		for (int i=0;i<N;i++)
@@ -73,7 +76,7 @@ public:
 		if (x.sign == 0) return;
 		copyWords(N,m,x.m);
 	}
-	template <int M> void set(const FPReal<M> & x)
+	template <int M> void set(const FPReal<M,Word> & x)
 	{
 		sign = x.sgn();
 		if (sign == 0) return;
@@ -149,15 +152,15 @@ public:
 	int round() const
 	{
 		if (sign == 0) return 0;
-		int u = m[0];
-		if (m[1] >= 0x80000000U) u++;
+		int u = (int)m[0];
+		if (m[1] >= ((word_t)1<<(WordBits-1))) u++;
 		return (sign>0)?u:-u;
 	}
 	// Return integer part
 	int intPart() const
 	{
 		if (sign == 0) return 0;
-		return sign * m[0];
+		return sign * (int)m[0];
 	}
 	// Convert to 'double'
 	operator double () const { return toDouble(); }
@@ -165,7 +168,7 @@ public:
 	{
 		if (sign == 0) return 0; // OK
 		double u = 0;
-		for (int i=0;i<N;i++) u += ldexp((double)m[i],-(i<<5));
+		for (int i=0;i<N;i++) u += ldexp((double)m[i],-i*WordBits);
 		return sign * u;
 	}
 	// Convert to decimal string. S cleared by the call.
@@ -174,31 +177,39 @@ public:
 		if (sign == 0) { s.assign("0"); return; }
 		char aux[100];
 		s.clear();
-		s.reserve(8+10*N); // We have 9.632 decimal digits per word
+		s.reserve(8+10*N*WordBits/32); // We have 9.632 decimal digits per 32 bits
 		s.append((sign < 0)?"-":"+");
 		word_t z[N];
 		copyWords(N,z,m);
-		int bits = 32 * N; // Bits to process
+		int bits = WordBits * N; // Bits to process
 		// Integer part
-		_snprintf(aux,100,"%d",z[0]);
+		_snprintf(aux,100,"%d",(int)z[0]);
 		s.append(aux); s.append(".");
-		bits -= 32;
+		bits -= WordBits;
 		// Fractional part
 		while (bits > 0)
 		{
 			z[0] = 0;
 			mulWords(N,100000,z,0);
-			_snprintf(aux,100,"%05d",z[0]);
+			_snprintf(aux,100,"%05d",(int)z[0]);
 			s.append(aux);
 			bits -= 16; // we processed 16.61 bits
 		}
 	}
 	// Copy M words of THIS into X[M]. Truncate or copy additional 0 when needed.
-	void getWords(int M,uint32 * x) const
+	void getWords(int M,word_t * x) const
 	{
 		copyWords(std::min(M,N),x,m);
 		if (M > N) zeroWords(M-N,x+N); // Pad extra output with 0
 	}
+	// Set THIS to SGN * X[N], X in the same order as words().
+	void setWords(int sgn,const word_t * x)
+	{
+		sign = sgn;
+		if (sign == 0) return;
+		copyWords(N,m,x);
+		checkZero();
+	}
 	// Return a pointer to the words (needed for template set from FPReal<M>).
 	const word_t * words() const { return m; }
 
@@ -270,7 +281,7 @@ public:
 	// THIS -= X
 	void sub(const FPReal & x)
 	{
-		FPReal<N> y(x);
+		FPReal y(x);
 		y.neg();
 		add(y);
 	}
@@ -297,46 +308,86 @@ public:
 	}
 
 	// THIS *= 2^K
-	// K may be negative, but is limited to -31,+31
+	// K may be negative, whole words are moved first
 	void mul2k(int k)
 	{
 		if (k == 0) return; // Z*1
 		if (sign == 0) return; // 0*2^K
-		if (k>0) shlWords(N,k,m,0);
+		int w = ((k>0)?k:-k) / WordBits;
+		if (w >= N) { zero(); return; }
+		if (k>0)
+		{
+			if (w > 0)
+			{
+				memmove(m,m+w,(N-w)*sizeof(m[0]));
+				zeroWords(w,m+N-w);
+			}
+			k -= w*WordBits;
+			if (k > 0) shlWords(N,k,m,0);
+		}
 		else
 		{
-			shrWords(N,-k,m,0);
-			checkZero();
+			if (w > 0)
+			{
+				memmove(m+w,m,(N-w)*sizeof(m[0]));
+				zeroWords(w,m);
+			}
+			k += w*WordBits;
+			if (k < 0) shrWords(N,-k,m,0);
 		}
+		checkZero();
 	}
 
 	// Z = X * Y (truncated to N words)
 	friend void mul(FPReal & z,const FPReal & x,const FPReal & y)
 	{
 		if (x.sign == 0 || y.sign == 0) { z.zero(); return; }
-		z.sign = x.sign * y.sign;
+		const int sign = x.sign * y.sign;
+		if (&z == &x || &z == &y)
+		{
+			// The product is accumulated in Z
+			word_t aux[N];
+			mulTruncWords(N,aux,x.m,y.m);
+			copyWords(N,z.m,aux);
+		}
+		else mulTruncWords(N,z.m,x.m,y.m);
+		z.sign = sign;
+	}
 
-		// Multiply (the trivial way) and accumulate in AUX
-		uint64 aux[N];
-		memset(aux,0,N*sizeof(aux[0]));
-		for (int i=0;i<N;i++) for (int j=0;j<N;j++)
+	// Z = X * X (truncated to N words), about half the work of mul
+	friend void sqr(FPReal & z,const FPReal & x)
+	{
+		if (x.sign == 0) { z.zero(); return; }
+		if (&z == &x)
 		{
-			int k = i+j;
-			if (k > N) continue; // ignored
-			uint64 u1 = (uint64)(x.m[i]) * (uint64)(y.m[j]);
-			uint64 u0 = u1 & 0xFFFFFFFFULL; // lower 32 bits, index K
-			u1 >>= (uint64)32; // higher 32 bits, index K-1
-			if (k < N) aux[k] += u0;
-			if (k > 0) aux[k-1] += u1;
+			word_t aux[N];
+			sqrTruncWords(N,aux,x.m);
+			copyWords(N,z.m,aux);
 		}
-		// Propagate carry into result
-		uint64 c = 0;
-		for (int i=N-1;i>=0;i--)
+		else sqrTruncWords(N,z.m,x.m);
+		z.sign = 1;
+	}
+
+	// Z = X * X - Y * Y + C, the real part of a Mandelbrot step.
+	// The squares are left in X2 and Y2 for the escape test. Both are
+	// positive, their difference needs no sign logic. Z may be X or Y.
+	friend void sqrDiffAdd(FPReal & z,FPReal & x2,FPReal & y2,const FPReal & x,const FPReal & y,const FPReal & c)
+	{
+		sqr(x2,x);
+		sqr(y2,y);
+		if (cmp(x2,y2) >= 0)
+		{
+			z.set(x2);
+			if (y2.sign != 0) subWords(N,z.m,y2.m,0);
+		}
+		else
 		{
-			c += aux[i];
-			z.m[i] = (uint32)(c & 0xFFFFFFFFULL);
-			c >>= (uint64)32;
+			z.set(y2);
+			if (x2.sign != 0) subWords(N,z.m,x2.m,0);
+			z.sign = -1;
 		}
+		z.checkZero();
+		z.add(c);
 	}
 
 private:
@@ -353,4 +404,64 @@ private:
 	word_t m[N];
 };
 
+// Z = T rounded to nearest on N words: half a unit of the last word of Z
+// is added to T, with the sign of T, and the guard word is dropped.
+template <int N, typename Word> void roundGuarded(FPReal<N,Word> & z,FPReal<N+1,Word> & t)
+{
+	typedef FPReal<N+1,Word> Guarded;
+	if (t.isZero()) { z.zero(); return; }
+	typename Guarded::word_t half[N+1];
+	zeroWords(N+1,half);
+	half[N] = (typename Guarded::word_t)1 << (Guarded::WordBits-1);
+	Guarded h;
+	h.setWords(t.sgn(),half);
+	t.add(h);
+	z.set(t);
+}
+
+// Z = 1 / X by Newton-Raphson, Y <- Y * (2 - X * Y), from a double
+// estimate. Each step doubles the correct bits. The truncated products
+// lose up to N units of the last word per step, so the last step runs
+// with one guard word and is rounded back: the result is within half a
+// unit of the last word. X must not be 0, and 1 / X must fit the integer
+// word.
+template <int N, typename Word> void inv(FPReal<N,Word> & z,const FPReal<N,Word> & x)
+{
+	if (x.isZero()) { z.zero(); return; }
+	typedef FPReal<N+1,Word> Guarded;
+	FPReal<N,Word> y(1.0 / x.toDouble());
+	// Relative bits needed to reach the last word, integer bits included
+	const int bits = (N-1) * FPReal<N,Word>::WordBits + std::max(0,y.logNorm()+1);
+	{
+		const FPReal<N,Word> two(2);
+		FPReal<N,Word> t, u;
+		for (int correct = 48; 2*correct < bits; correct *= 2)
+		{
+			mul(t,x,y);
+			u = two;
+			u.sub(t);
+			mul(t,y,u);
+			y = t;
+		}
+	}
+	// Last step on N+1 words
+	const Guarded two(2), gx(x), gy(y);
+	Guarded t, u;
+	mul(t,gx,gy);
+	u = two;
+	u.sub(t);
+	mul(t,gy,u);
+	roundGuarded(z,t);
+}
+
+// Z = X / Y, as X * (1 / Y) on N+1 words, rounded back to N words
+template <int N, typename Word> void div(FPReal<N,Word> & z,const FPReal<N,Word> & x,const FPReal<N,Word> & y)
+{
+	typedef FPReal<N+1,Word> Guarded;
+	Guarded r, q;
+	inv(r,Guarded(y));
+	mul(q,Guarded(x),r);
+	roundGuarded(z,q);
+}
+
 #endif // #ifndef FPReal_h
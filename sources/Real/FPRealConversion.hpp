@@ -0,0 +1,98 @@
+/*
+ *  FPRealConversion.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef FPREAL_CONVERSION_HPP
+#define FPREAL_CONVERSION_HPP
+
+#include <mpir/gmp.h>
+#include <cstring>
+#include "FPReal.hpp"
+
+// Conversions between mpf and FPReal without going through a double.
+// The words of an FPReal<N> spell the integer |x| * 2^(WordBits * (N-1)),
+// which mpz imports and exports as is.
+
+// Z = X truncated toward 0 to the N words, exact when X fits them.
+// The integer part of X must fit the first word.
+template <int N, typename Word>
+void toFPReal(FPReal<N, Word>& z, mpf_srcptr x)
+{
+	const int wordBits = FPReal<N, Word>::WordBits;
+	mpf_t scaled;
+	mpz_t words;
+	mpf_init2(scaled, mpf_get_prec(x));
+	mpz_init(words);
+
+	mpf_abs(scaled, x);
+	mpf_mul_2exp(scaled, scaled, wordBits * (N - 1));
+	mpz_set_f(words, scaled);
+
+	Word m[N];
+	size_t count = 0;
+	zeroWords(N, m);
+	if (mpz_sizeinbase(words, 2) <= (size_t)(wordBits * N))
+		mpz_export(m, &count, 1, sizeof(Word), 0, 0, words);
+
+	// mpz_export writes the most significant word first, right align it
+	if (count > 0 && count < N)
+	{
+		memmove(m + N - count, m, count * sizeof(Word));
+		zeroWords(N - (int)count, m);
+	}
+
+	z.setWords(mpf_sgn(x), m);
+
+	mpz_clear(words);
+	mpf_clear(scaled);
+}
+
+// Z = X exactly, Z's precision is raised to hold every word if needed
+template <int N, typename Word>
+void toMpf(mpf_ptr z, const FPReal<N, Word>& x)
+{
+	const int wordBits = FPReal<N, Word>::WordBits;
+
+	if (mpf_get_prec(z) < (mp_bitcnt_t)(wordBits * N))
+		mpf_set_prec(z, wordBits * N);
+
+	if (x.isZero())
+	{
+		mpf_set_ui(z, 0);
+		return;
+	}
+
+	mpz_t words;
+	mpz_init(words);
+	mpz_import(words, N, 1, sizeof(Word), 0, 0, x.words());
+
+	mpf_set_z(z, words);
+	mpf_div_2exp(z, z, wordBits * (N - 1));
+	if (x.sgn() < 0)
+		mpf_neg(z, z);
+
+	mpz_clear(words);
+}
+
+#endif
@@ -6,6 +6,14 @@
 
 #include <string.h>
 
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#define MPBASE_X64
+#elif defined(__x86_64__)
+#include <x86intrin.h>
+#define MPBASE_X64
+#endif
+
 #ifdef WIN32
 typedef unsigned __int32 uint32;
 typedef unsigned __int64 uint64;
@@ -164,4 +172,305 @@ inline int msbWords(int n,const uint32 * x)
 	return -1;
 }
 
+// 64-bit limb versions of the functions above, same semantics on
+// unsigned arrays of N 64-bit words. They use the add-with-carry and
+// 64x64->128 multiply instructions of x86-64 when available.
+
+// Return A + B + CARRY in Z, and the output carry.
+inline unsigned char addLimb(unsigned char carry,uint64 a,uint64 b,uint64 * z)
+{
+#ifdef MPBASE_X64
+	return _addcarry_u64(carry,a,b,(unsigned long long *)z);
+#else
+	uint64 s = a + carry;
+	unsigned char c = (s < a);
+	*z = s + b;
+	return c | (unsigned char)(*z < b);
+#endif
+}
+
+// Return A - B - BORROW in Z, and the output borrow.
+inline unsigned char subLimb(unsigned char borrow,uint64 a,uint64 b,uint64 * z)
+{
+#ifdef MPBASE_X64
+	return _subborrow_u64(borrow,a,b,(unsigned long long *)z);
+#else
+	uint64 d = a - b;
+	unsigned char c = (a < b);
+	*z = d - borrow;
+	return c | (unsigned char)(d < (uint64)borrow);
+#endif
+}
+
+// Return the low word of A*B, and the high word in HI.
+inline uint64 mulLimb(uint64 a,uint64 b,uint64 * hi)
+{
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+	return _mulx_u64(a,b,(unsigned long long *)hi);
+#elif defined(__SIZEOF_INT128__)
+	unsigned __int128 p = (unsigned __int128)a * b;
+	*hi = (uint64)(p >> 64);
+	return (uint64)p;
+#elif defined(_MSC_VER) && defined(_M_X64)
+	return _umul128(a,b,hi);
+#else
+	uint64 a0 = a & 0xFFFFFFFFULL, a1 = a >> 32;
+	uint64 b0 = b & 0xFFFFFFFFULL, b1 = b >> 32;
+	uint64 p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+	uint64 mid = (p00 >> 32) + (p01 & 0xFFFFFFFFULL) + (p10 & 0xFFFFFFFFULL);
+	*hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+	return (mid << 32) | (p00 & 0xFFFFFFFFULL);
+#endif
+}
+
+// Zero unsigned array of N limbs.
+inline void zeroWords(int n,uint64 * z)
+{
+	memset(z,0,n*sizeof(z[0]));
+}
+
+// Copy unsigned array of N limbs.
+inline void copyWords(int n,uint64 * z,const uint64 * x)
+{
+	memcpy(z,x,n*sizeof(z[0]));
+}
+
+// Add unsigned arrays of N limbs.
+// CARRY is input carry.
+// Return value is output carry.
+inline uint64 addWords(int n,uint64 * z,const uint64 * x,uint64 carry)
+{
+	unsigned char c = (unsigned char)carry;
+	for (int i=n-1;i>=0;i--) c = addLimb(c,z[i],x[i],z+i);
+	return c;
+}
+
+// Sub unsigned arrays of N limbs.
+// BORROW is input borrow.
+// Return value is output borrow.
+inline uint64 subWords(int n,uint64 * z,const uint64 * x,uint64 borrow)
+{
+	unsigned char c = (unsigned char)borrow;
+	for (int i=n-1;i>=0;i--) c = subLimb(c,z[i],x[i],z+i);
+	return c;
+}
+
+// Mul unsigned arrays of N limbs.
+// CARRY is input carry.
+// Return value is output carry.
+inline uint64 mulWords(int n,uint64 k,uint64 * z,uint64 carry)
+{
+	uint64 c = carry;
+	for (int i=n-1;i>=0;i--)
+	{
+		uint64 hi;
+		uint64 lo = mulLimb(z[i],k,&hi);
+		hi += addLimb(0,lo,c,z+i);
+		c = hi;
+	}
+	return c;
+}
+
+// Div unsigned arrays of N limbs, K < 2^32.
+// REM is input remainder (must be <K).
+// Return value is output remainder.
+inline uint64 divWords(int n,uint64 k,uint64 * z,uint64 rem)
+{
+	uint64 c = rem;
+	for (int i=0;i<n;i++)
+	{
+		// Two 32-bit steps, C < K keeps the partial dividends in 64 bits
+		uint64 y = (c<<32) | (z[i]>>32);
+		uint64 q1 = y/k;
+		c = y%k;
+		y = (c<<32) | (z[i] & 0xFFFFFFFFULL);
+		z[i] = (q1<<32) | (y/k);
+		c = y%k;
+	}
+	return c;
+}
+
+// Shift left N limbs by K bits (0<K<64).
+// BITS are input bits (K bits).
+// Return value are output bits (K bits).
+inline uint64 shlWords(int n,uint64 k,uint64 * z,uint64 bits)
+{
+	uint64 c = bits & (((uint64)1<<k)-1);
+	for (int i=n-1;i>=0;i--)
+	{
+		uint64 y = z[i];
+		z[i] = (y<<k) | c;
+		c = y >> (64-k);
+	}
+	return c;
+}
+
+// Shift right N limbs by K bits (0<K<64).
+// BITS are input bits (K bits).
+// Return value are output bits (K bits).
+inline uint64 shrWords(int n,uint64 k,uint64 * z,uint64 bits)
+{
+	uint64 mask = ((uint64)1<<k)-1;
+	uint64 c = bits & mask;
+	for (int i=0;i<n;i++)
+	{
+		uint64 y = z[i];
+		z[i] = (y>>k) | (c<<(64-k));
+		c = y & mask;
+	}
+	return c;
+}
+
+// Compare unsigned arrays of N limbs.
+inline int cmpWords(int n,const uint64 * x,const uint64 * y)
+{
+	for (int i=0;i<n;i++)
+	{
+		if (x[i]>y[i]) return 1;
+		if (x[i]<y[i]) return -1;
+	}
+	return 0;
+}
+
+// Check if all N limbs of X are 0
+inline bool checkZeroWords(int n,const uint64 * x)
+{
+	for (int i=0;i<n;i++)
+	{
+		if (x[i] != 0) return false;
+	}
+	return true;
+}
+
+// Get index of most significant set bit in limb X, or -1 if 0.
+inline int msbWord(uint64 x)
+{
+	if (x >> 32) return 32 + msbWord((uint32)(x >> 32));
+	return msbWord((uint32)x);
+}
+
+// Get index of most significant set bit in N limbs, or -1 if 0.
+inline int msbWords(int n,const uint64 * x)
+{
+	for (int i=0;i<n;i++)
+	{
+		int m = msbWord(x[i]);
+		if (m >= 0) { return m+((n-i-1)<<6); }
+	}
+	return -1;
+}
+
+// Z = X * Y truncated to the N most significant words, X, Y and Z
+// being fixed point numbers with the point after their first word
+// (N <= 64).
+// Products landing below word N-1 are dropped, except for the high
+// half of the ones of weight N.
+inline void mulTruncWords(int n,uint32 * z,const uint32 * x,const uint32 * y)
+{
+	// Multiply (the trivial way) and accumulate in AUX, columns
+	// beyond N are never computed
+	uint64 aux[64];
+	memset(aux,0,n*sizeof(aux[0]));
+	for (int i=0;i<n;i++) for (int j=0;j<n && i+j<=n;j++)
+	{
+		int k = i+j;
+		uint64 u1 = (uint64)(x[i]) * (uint64)(y[j]);
+		uint64 u0 = u1 & 0xFFFFFFFFULL; // lower 32 bits, index K
+		u1 >>= (uint64)32; // higher 32 bits, index K-1
+		if (k < n) aux[k] += u0;
+		if (k > 0) aux[k-1] += u1;
+	}
+	// Propagate carry into result
+	uint64 c = 0;
+	for (int i=n-1;i>=0;i--)
+	{
+		c += aux[i];
+		z[i] = (uint32)(c & 0xFFFFFFFFULL);
+		c >>= (uint64)32;
+	}
+}
+
+// Same on limbs, column by column into a three limb accumulator.
+// Z must not overlap X or Y.
+inline void mulTruncWords(int n,uint64 * z,const uint64 * x,const uint64 * y)
+{
+	uint64 a0 = 0, a1 = 0, a2 = 0; // a0 has the weight of column K
+	for (int k=n;k>=0;k--)
+	{
+		int i0 = (k < n) ? 0 : 1;
+		for (int i=i0;i<=k && i<n;i++)
+		{
+			uint64 hi;
+			uint64 lo = mulLimb(x[i],y[k-i],&hi);
+			unsigned char c = addLimb(0,a0,lo,&a0);
+			c = addLimb(c,a1,hi,&a1);
+			a2 += c;
+		}
+		if (k < n) z[k] = a0;
+		a0 = a1; a1 = a2; a2 = 0;
+	}
+}
+
+// Z = X * X truncated like mulTruncWords, each product X[I]*X[J] with
+// I != J computed once and doubled: about half the multiplies.
+inline void sqrTruncWords(int n,uint32 * z,const uint32 * x)
+{
+	uint64 aux[64];
+	memset(aux,0,n*sizeof(aux[0]));
+	for (int i=0;i<n;i++) for (int j=i;j<n && i+j<=n;j++)
+	{
+		int k = i+j;
+		uint64 u1 = (uint64)(x[i]) * (uint64)(x[j]);
+		uint64 u0 = u1 & 0xFFFFFFFFULL; // lower 32 bits, index K
+		u1 >>= (uint64)32; // higher 32 bits, index K-1
+		if (i != j) { u0 <<= 1; u1 <<= 1; }
+		if (k < n) aux[k] += u0;
+		if (k > 0) aux[k-1] += u1;
+	}
+	// Propagate carry into result
+	uint64 c = 0;
+	for (int i=n-1;i>=0;i--)
+	{
+		c += aux[i];
+		z[i] = (uint32)(c & 0xFFFFFFFFULL);
+		c >>= (uint64)32;
+	}
+}
+
+// Same on limbs. The cross products of a column are summed, doubled,
+// then the square of its middle limb is added.
+// Z must not overlap X.
+inline void sqrTruncWords(int n,uint64 * z,const uint64 * x)
+{
+	uint64 a0 = 0, a1 = 0, a2 = 0; // a0 has the weight of column K
+	for (int k=n;k>=0;k--)
+	{
+		uint64 t0 = 0, t1 = 0, t2 = 0;
+		uint64 hi, lo;
+		unsigned char c;
+		for (int i=(k < n) ? 0 : 1;2*i<k;i++)
+		{
+			lo = mulLimb(x[i],x[k-i],&hi);
+			c = addLimb(0,t0,lo,&t0);
+			c = addLimb(c,t1,hi,&t1);
+			t2 += c;
+		}
+		t2 = (t2<<1) | (t1>>63);
+		t1 = (t1<<1) | (t0>>63);
+		t0 <<= 1;
+		if ((k & 1) == 0)
+		{
+			lo = mulLimb(x[k>>1],x[k>>1],&hi);
+			c = addLimb(0,t0,lo,&t0);
+			c = addLimb(c,t1,hi,&t1);
+			t2 += c;
+		}
+		c = addLimb(0,a0,t0,&a0);
+		c = addLimb(c,a1,t1,&a1);
+		a2 += t2 + c;
+		if (k < n) z[k] = a0;
+		a0 = a1; a1 = a2; a2 = 0;
+	}
+}
+
 #endif // #ifndef MPBase_h
@@ -0,0 +1,166 @@
+/*
+ *  doubledouble.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef DOUBLEDOUBLE_HPP
+#define DOUBLEDOUBLE_HPP
+
+#include <cmath>
+
+// Unevaluated sum of two doubles, hi + lo with |lo| <= ulp(hi) / 2:
+// about 106 bits of mantissa for the price of a handful of double
+// operations. The error free transformations below need strict IEEE
+// double arithmetic, never build this with fast math.
+class doubledouble
+{
+public:
+	doubledouble() : hi(0), lo(0) {}
+	doubledouble(double x) : hi(x), lo(0) {}
+	doubledouble(int x) : hi(x), lo(0) {}
+	doubledouble(double high, double low) { quickTwoSum(high, low, hi, lo); }
+
+	double high() const { return hi; }
+	double low() const { return lo; }
+	double toDouble() const { return hi + lo; }
+
+	// Arithmetic
+
+	friend doubledouble operator - (const doubledouble& x)
+	{
+		return make(-x.hi, -x.lo);
+	}
+
+	friend doubledouble operator + (const doubledouble& x, const doubledouble& y)
+	{
+		double s, e;
+		twoSum(x.hi, y.hi, s, e);
+		e += x.lo + y.lo;
+		quickTwoSum(s, e, s, e);
+		return make(s, e);
+	}
+
+	friend doubledouble operator - (const doubledouble& x, const doubledouble& y)
+	{
+		return x + (-y);
+	}
+
+	friend doubledouble operator * (const doubledouble& x, const doubledouble& y)
+	{
+		double p, e;
+		twoProd(x.hi, y.hi, p, e);
+		e += x.hi * y.lo + x.lo * y.hi;
+		quickTwoSum(p, e, p, e);
+		return make(p, e);
+	}
+
+	doubledouble& operator += (const doubledouble& x) { return *this = *this + x; }
+	doubledouble& operator -= (const doubledouble& x) { return *this = *this - x; }
+	doubledouble& operator *= (const doubledouble& x) { return *this = *this * x; }
+
+	// THIS * 2, exact
+	doubledouble mul2() const
+	{
+		return make(2.0 * hi, 2.0 * lo);
+	}
+
+	friend doubledouble sqr(const doubledouble& x)
+	{
+		double p, e;
+		twoProd(x.hi, x.hi, p, e);
+		e += 2.0 * x.hi * x.lo;
+		quickTwoSum(p, e, p, e);
+		return make(p, e);
+	}
+
+	// Comparisons
+
+	friend bool operator < (const doubledouble& x, const doubledouble& y)
+	{
+		return x.hi < y.hi || (x.hi == y.hi && x.lo < y.lo);
+	}
+
+	friend bool operator > (const doubledouble& x, const doubledouble& y) { return y < x; }
+	friend bool operator <= (const doubledouble& x, const doubledouble& y) { return !(y < x); }
+	friend bool operator >= (const doubledouble& x, const doubledouble& y) { return !(x < y); }
+	friend bool operator == (const doubledouble& x, const doubledouble& y) { return x.hi == y.hi && x.lo == y.lo; }
+	friend bool operator != (const doubledouble& x, const doubledouble& y) { return !(x == y); }
+
+	// Error free transformations, also used by the vectorized engines
+
+	// s + e = a + b exactly
+	static void twoSum(double a, double b, double& s, double& e)
+	{
+		s = a + b;
+		const double bb = s - a;
+		e = (a - (s - bb)) + (b - bb);
+	}
+
+	// s + e = a + b exactly, provided |a| >= |b|
+	static void quickTwoSum(double a, double b, double& s, double& e)
+	{
+		const double sum = a + b;
+		e = b - (sum - a);
+		s = sum;
+	}
+
+	// p + e = a * b exactly: one FMA when the target has it, Dekker's
+	// split otherwise
+	static void twoProd(double a, double b, double& p, double& e)
+	{
+		p = a * b;
+#if defined(__FMA__) || defined(__AVX2__)
+		e = std::fma(a, b, -p);
+#else
+		double ah, al, bh, bl;
+		split(a, ah, al);
+		split(b, bh, bl);
+		e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif
+	}
+
+private:
+	// Already normalized pair
+	static doubledouble make(double high, double low)
+	{
+		doubledouble r;
+		r.hi = high;
+		r.lo = low;
+		return r;
+	}
+
+	// a = h + l with h and l holding 26 bits each
+	static void split(double a, double& h, double& l)
+	{
+		const double t = 134217729.0 * a; // 2^27 + 1
+		h = t - (t - a);
+		l = a - h;
+	}
+
+	double hi;
+	double lo;
+};
+
+inline double toDouble(const doubledouble& x) { return x.toDouble(); }
+
+#endif
@@ -0,0 +1,216 @@
+/*
+ *  floatexp.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef FLOATEXP_HPP
+#define FLOATEXP_HPP
+
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <ostream>
+
+// Double mantissa with a separate 64 bit exponent: value = m * 2^e with
+// |m| in [1,2), or m = 0. Keeps 53 bits of precision far beyond the
+// 1e-308 .. 1e308 range of double, for zooms and perturbation deltas.
+class floatexp
+{
+public:
+	typedef int64_t exp_t;
+
+	// Exponent of 0, low enough to lose every comparison and addition
+	// but far enough from the int64 limits to survive a few products
+	static const exp_t ZeroExponent = -((exp_t)1 << 60);
+
+	floatexp() : m(0), e(ZeroExponent) {}
+	floatexp(double x) : m(x), e(0) { normalize(); }
+	floatexp(int x) : m(x), e(0) { normalize(); }
+	floatexp(double mantissa, exp_t exponent) : m(mantissa), e(exponent) { normalize(); }
+
+	double mantissa() const { return m; }
+	exp_t exponent() const { return e; }
+	bool isZero() const { return m == 0; }
+	int sgn() const { return (m > 0) - (m < 0); }
+
+	double toDouble() const
+	{
+		if (e >= -1022 && e <= 1023)
+			return m * pow2(e);
+		if (e < -1022)
+			return (e < -1080) ? 0.0 : std::ldexp(m, (int)e);
+		return std::ldexp(m, 1024); // +/- infinity
+	}
+
+	// Arithmetic
+
+	friend floatexp operator - (const floatexp& x)
+	{
+		floatexp r;
+		r.m = -x.m;
+		r.e = x.e;
+		return r;
+	}
+
+	friend floatexp operator + (const floatexp& x, const floatexp& y)
+	{
+		if (y.m == 0) return x;
+		if (x.m == 0) return y;
+
+		const exp_t d = x.e - y.e;
+		if (d > 60) return x;
+		if (d < -60) return y;
+
+		if (d >= 0) return floatexp(x.m + y.m * pow2(-d), x.e);
+		return floatexp(x.m * pow2(d) + y.m, y.e);
+	}
+
+	friend floatexp operator - (const floatexp& x, const floatexp& y)
+	{
+		return x + (-y);
+	}
+
+	friend floatexp operator * (const floatexp& x, const floatexp& y)
+	{
+		return floatexp(x.m * y.m, x.e + y.e);
+	}
+
+	friend floatexp operator / (const floatexp& x, const floatexp& y)
+	{
+		return floatexp(x.m / y.m, x.e - y.e);
+	}
+
+	floatexp& operator += (const floatexp& x) { return *this = *this + x; }
+	floatexp& operator -= (const floatexp& x) { return *this = *this - x; }
+	floatexp& operator *= (const floatexp& x) { return *this = *this * x; }
+	floatexp& operator /= (const floatexp& x) { return *this = *this / x; }
+
+	// THIS * 2^k, exact
+	floatexp mul2k(exp_t k) const
+	{
+		floatexp r(*this);
+		if (m != 0) r.e += k;
+		return r;
+	}
+
+	friend floatexp abs(const floatexp& x)
+	{
+		floatexp r(x);
+		if (r.m < 0) r.m = -r.m;
+		return r;
+	}
+
+	friend floatexp sqrt(const floatexp& x)
+	{
+		if (x.m <= 0) return floatexp();
+		// Make the exponent even so it can be halved exactly
+		if (x.e & 1) return floatexp(std::sqrt(2.0 * x.m), (x.e - 1) / 2);
+		return floatexp(std::sqrt(x.m), x.e / 2);
+	}
+
+	// Comparisons
+
+	friend bool operator < (const floatexp& x, const floatexp& y)
+	{
+		const int sx = x.sgn();
+		const int sy = y.sgn();
+		if (sx != sy) return sx < sy;
+		if (sx == 0) return false;
+		if (x.e != y.e) return (sx > 0) ? (x.e < y.e) : (x.e > y.e);
+		return x.m < y.m;
+	}
+
+	friend bool operator > (const floatexp& x, const floatexp& y) { return y < x; }
+	friend bool operator <= (const floatexp& x, const floatexp& y) { return !(y < x); }
+	friend bool operator >= (const floatexp& x, const floatexp& y) { return !(x < y); }
+	friend bool operator == (const floatexp& x, const floatexp& y) { return x.m == y.m && x.e == y.e; }
+	friend bool operator != (const floatexp& x, const floatexp& y) { return !(x == y); }
+
+	// Decimal scientific notation, the exponent may exceed double's
+	friend std::ostream& operator << (std::ostream& stream, const floatexp& x)
+	{
+		if (x.m == 0) return stream << 0.0;
+
+		const double log10 = std::log10(std::fabs(x.m)) + (double)x.e * 0.30102999566398119521;
+		const double exponent = std::floor(log10);
+		const double mantissa = std::pow(10.0, log10 - exponent);
+
+		if (exponent > -5 && exponent < 15)
+			return stream << x.toDouble();
+
+		return stream << ((x.m < 0) ? -mantissa : mantissa) << "e" << (exponent >= 0 ? "+" : "") << (int64_t)exponent;
+	}
+
+private:
+	// 2^k for k in [-1022, 1023], built directly from its bits
+	static double pow2(exp_t k)
+	{
+		uint64_t bits = (uint64_t)(k + 1023) << 52;
+		double r;
+		memcpy(&r, &bits, sizeof(r));
+		return r;
+	}
+
+	// Bring m back to [1,2), moving its binary exponent to e
+	void normalize()
+	{
+		if (m == 0)
+		{
+			e = ZeroExponent;
+			return;
+		}
+
+		uint64_t bits;
+		memcpy(&bits, &m, sizeof(bits));
+		const int biased = (int)((bits >> 52) & 0x7FF);
+
+		if (biased == 0x7FF)
+			return; // inf or nan, nothing sensible to do
+
+		if (biased == 0)
+		{
+			// Denormal mantissa
+			int k;
+			m = 2.0 * std::frexp(m, &k);
+			e += k - 1;
+			return;
+		}
+
+		e += biased - 1023;
+		bits = (bits & 0x800FFFFFFFFFFFFFULL) | (1023ULL << 52);
+		memcpy(&m, &bits, sizeof(m));
+	}
+
+	double m;
+	exp_t e;
+};
+
+// Conversions for code templated on double or floatexp
+template <typename T> T floatexp_cast(const floatexp& x);
+template <> inline double floatexp_cast<double>(const floatexp& x) { return x.toDouble(); }
+template <> inline floatexp floatexp_cast<floatexp>(const floatexp& x) { return x; }
+
+inline double toDouble(double x) { return x; }
+inline double toDouble(const floatexp& x) { return x.toDouble(); }
+
+#endif
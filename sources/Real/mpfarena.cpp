@@ -0,0 +1,178 @@
+/*
+ *  mpfarena.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "mpfarena.hpp"
+#include <mpir/gmp.h>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/ThreadLocalPtr.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	// Block of every thread that opens a scope, plenty for the few mpf
+	// of a tile at a few thousand bits
+	const size_t blockSize = 1 << 20;
+
+	// Alignment of every arena allocation
+	const size_t alignment = 16;
+
+	struct ThreadArena
+	{
+		ThreadArena() : block(NULL), top(0), depth(0) {}
+
+		bool owns(const void *ptr) const
+		{
+			return block != NULL && (const char *)ptr >= block && (const char *)ptr < block + blockSize;
+		}
+
+		char *block;
+		size_t top;
+		unsigned depth;
+		mpfarena::Statistics statistics;
+	};
+
+	// Arenas of all the threads, for the statistics. They are never
+	// destroyed: OpenMP keeps its threads alive between frames.
+	std::vector<ThreadArena *> arenas;
+	sf::Mutex arenasMutex;
+
+	sf::ThreadLocalPtr<ThreadArena> currentArena(NULL);
+
+	ThreadArena& threadArena()
+	{
+		if (currentArena == NULL)
+		{
+			ThreadArena *arena = new ThreadArena();
+			currentArena = arena;
+
+			sf::Lock lock(arenasMutex);
+			arenas.push_back(arena);
+		}
+
+		return *currentArena;
+	}
+
+	size_t aligned(size_t size)
+	{
+		return (size + alignment - 1) & ~(alignment - 1);
+	}
+
+	void *allocate(size_t size)
+	{
+		ThreadArena& arena = threadArena();
+
+		if (arena.depth > 0 && arena.top + aligned(size) <= blockSize)
+		{
+			void *ptr = arena.block + arena.top;
+			arena.top += aligned(size);
+			++arena.statistics.arenaAllocations;
+			arena.statistics.arenaBytes += size;
+			return ptr;
+		}
+
+		++arena.statistics.heapAllocations;
+		return std::malloc(size);
+	}
+
+	void release(void *ptr, size_t size)
+	{
+		ThreadArena& arena = threadArena();
+
+		if (!arena.owns(ptr))
+		{
+			std::free(ptr);
+			return;
+		}
+
+		// The last allocation of the block is handed back right away,
+		// the others when their scope ends
+		if ((char *)ptr + aligned(size) == arena.block + arena.top)
+			arena.top -= aligned(size);
+	}
+
+	void *reallocate(void *ptr, size_t oldSize, size_t newSize)
+	{
+		ThreadArena& arena = threadArena();
+
+		if (!arena.owns(ptr))
+			return std::realloc(ptr, newSize);
+
+		// Last allocation of the block: grow or shrink it in place
+		const size_t offset = (char *)ptr - arena.block;
+		if (offset + aligned(oldSize) == arena.top && offset + aligned(newSize) <= blockSize)
+		{
+			arena.top = offset + aligned(newSize);
+			return ptr;
+		}
+
+		void *result = allocate(newSize);
+		std::memcpy(result, ptr, (oldSize < newSize) ? oldSize : newSize);
+		release(ptr, oldSize);
+		return result;
+	}
+}
+
+void mpfarena::install()
+{
+	mp_set_memory_functions(allocate, reallocate, release);
+}
+
+mpfarena::Statistics mpfarena::getStatistics()
+{
+	sf::Lock lock(arenasMutex);
+
+	Statistics total;
+	for (size_t i = 0; i < arenas.size(); ++i)
+	{
+		total.arenaAllocations += arenas[i]->statistics.arenaAllocations;
+		total.heapAllocations += arenas[i]->statistics.heapAllocations;
+		total.arenaBytes += arenas[i]->statistics.arenaBytes;
+	}
+
+	return total;
+}
+
+mpfarena::Scope::Scope() :
+m_mark(0)
+{
+	ThreadArena& arena = threadArena();
+
+	if (arena.block == NULL)
+		arena.block = (char *)std::malloc(blockSize);
+
+	m_mark = arena.top;
+	++arena.depth;
+}
+
+mpfarena::Scope::~Scope()
+{
+	ThreadArena& arena = threadArena();
+
+	arena.top = m_mark;
+	--arena.depth;
+}
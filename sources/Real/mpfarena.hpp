@@ -0,0 +1,78 @@
+/*
+ *  mpfarena.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef MPFARENA_HPP
+#define MPFARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Allocator behind the limbs of every mpf once install() has run.
+// Inside an mpfarena::Scope, the allocations of the calling thread are
+// carved from a block owned by that thread and all released when the
+// scope ends: no malloc, no free, no lock shared with the other threads.
+// Outside of any scope, or once the block is full, they go to the heap
+// as before.
+// Every mpf initialized inside a scope must be cleared before the scope
+// ends: declare the scope before the mpfreal objects it covers.
+class mpfarena
+{
+public:
+	struct Statistics
+	{
+		Statistics() : arenaAllocations(0), heapAllocations(0), arenaBytes(0) {}
+
+		// Allocations served by an arena, each one a malloc avoided, and
+		// the ones that still went to the heap
+		uint64_t arenaAllocations;
+		uint64_t heapAllocations;
+		uint64_t arenaBytes;
+	};
+
+	// Route GMP allocations through the arenas. Call it before the
+	// first mpf is initialized, GMP must free what it allocated with
+	// the functions it was allocated with.
+	static void install();
+
+	// Totals of every thread since install()
+	static Statistics getStatistics();
+
+	// A unit of mpf work of the calling thread, a tile or a column:
+	// whatever it allocates is released at once when it ends. Scopes nest.
+	class Scope
+	{
+	public:
+		Scope();
+		~Scope();
+
+	private:
+		Scope(const Scope&);
+		Scope& operator=(const Scope&);
+
+		size_t m_mark;
+	};
+};
+
+#endif
@@ -0,0 +1,302 @@
+/*
+ *  mpfexpr.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef MPFEXPR_HPP
+#define MPFEXPR_HPP
+
+#include <mpir/gmp.h>
+
+class mpfreal;
+template <unsigned Bits> class mpfreal_fixed;
+
+// Expression templates over mpfreal and mpfreal_fixed: zx * zx - zy * zy
+// + cx builds a small tree of references, evaluated by the assignment
+// straight into the destination. Operands are read in place, a
+// temporary is only created when both sides of an operation need
+// computing, and it is of the operands' own type: on the stack, without
+// any allocation, for mpfreal_fixed.
+// Like any expression template, an expression only refers to its
+// operands: evaluate it in the statement that builds it.
+namespace mpfexpr
+{
+	// Maps the types that can appear in an expression to their node
+	template <typename T> struct Traits {};
+
+	// T, once Dummy is known to exist
+	template <typename T, typename Dummy> struct Enable
+	{
+		typedef T type;
+	};
+
+	struct AddOp
+	{
+		static void apply(mpf_ptr r, mpf_srcptr a, mpf_srcptr b) { mpf_add(r, a, b); }
+	};
+
+	struct SubOp
+	{
+		static void apply(mpf_ptr r, mpf_srcptr a, mpf_srcptr b) { mpf_sub(r, a, b); }
+	};
+
+	struct MulOp
+	{
+		static void apply(mpf_ptr r, mpf_srcptr a, mpf_srcptr b) { mpf_mul(r, a, b); }
+	};
+
+	// An existing number, used where it is
+	template <typename Real>
+	struct Operand
+	{
+		typedef Real scratch_type;
+
+		// mpf calls needed to evaluate the node
+		static const int operations = 0;
+		static const bool isLeaf = true;
+
+		explicit Operand(const Real& real) : value(*real) {}
+
+		mpf_srcptr pointer() const { return value; }
+		bool references(mpf_srcptr p) const { return value == p; }
+		void evaluate(mpf_ptr result) const { mpf_set(result, value); }
+
+		mpf_srcptr value;
+	};
+
+	template <typename Op, typename L, typename R>
+	struct Binary
+	{
+		typedef typename L::scratch_type scratch_type;
+
+		static const int operations = L::operations + R::operations + 1;
+		static const bool isLeaf = false;
+
+		Binary(const L& left, const R& right) : l(left), r(right) {}
+
+		mpf_srcptr pointer() const { return 0; }
+		bool references(mpf_srcptr p) const { return l.references(p) || r.references(p); }
+
+		// Evaluate in result, itself when possible, and only use a
+		// temporary when result is still to be read
+		void evaluate(mpf_ptr result) const
+		{
+			if (L::isLeaf && R::isLeaf)
+			{
+				Op::apply(result, l.pointer(), r.pointer());
+			}
+			else if (R::isLeaf)
+			{
+				if (!r.references(result))
+				{
+					l.evaluate(result);
+					Op::apply(result, result, r.pointer());
+				}
+				else
+				{
+					scratch_type t;
+					l.evaluate(*t);
+					Op::apply(result, *t, r.pointer());
+				}
+			}
+			else if (L::isLeaf)
+			{
+				if (!l.references(result))
+				{
+					r.evaluate(result);
+					Op::apply(result, l.pointer(), result);
+				}
+				else
+				{
+					scratch_type t;
+					r.evaluate(*t);
+					Op::apply(result, l.pointer(), *t);
+				}
+			}
+			else
+			{
+				scratch_type t;
+				if (!r.references(result))
+				{
+					l.evaluate(result);
+					r.evaluate(*t);
+					Op::apply(result, result, *t);
+				}
+				else if (!l.references(result))
+				{
+					r.evaluate(result);
+					l.evaluate(*t);
+					Op::apply(result, *t, result);
+				}
+				else
+				{
+					scratch_type u;
+					l.evaluate(*t);
+					r.evaluate(*u);
+					Op::apply(result, *t, *u);
+				}
+			}
+		}
+
+		L l;
+		R r;
+	};
+
+	// E * 2^k, exact and much cheaper than a product
+	template <typename E>
+	struct Mul2k
+	{
+		typedef typename E::scratch_type scratch_type;
+
+		static const int operations = E::operations + 1;
+		static const bool isLeaf = false;
+
+		Mul2k(const E& expression, unsigned long exponent) : e(expression), k(exponent) {}
+
+		mpf_srcptr pointer() const { return 0; }
+		bool references(mpf_srcptr p) const { return e.references(p); }
+
+		void evaluate(mpf_ptr result) const
+		{
+			if (E::isLeaf)
+			{
+				mpf_mul_2exp(result, e.pointer(), k);
+			}
+			else
+			{
+				e.evaluate(result);
+				mpf_mul_2exp(result, result, k);
+			}
+		}
+
+		E e;
+		unsigned long k;
+	};
+
+	template <> struct Traits<mpfreal>
+	{
+		typedef Operand<mpfreal> node;
+		typedef void assignable;
+	};
+
+	template <unsigned Bits> struct Traits<mpfreal_fixed<Bits> >
+	{
+		typedef Operand<mpfreal_fixed<Bits> > node;
+		typedef void assignable;
+	};
+
+	template <typename Op, typename L, typename R> struct Traits<Binary<Op, L, R> >
+	{
+		typedef Binary<Op, L, R> node;
+		typedef void assignable;
+	};
+
+	template <typename E> struct Traits<Mul2k<E> >
+	{
+		typedef Mul2k<E> node;
+		typedef void assignable;
+	};
+
+	// Value of a node, computed in a temporary unless it is a leaf
+	template <typename E>
+	int compare(const E& e, int value)
+	{
+		if (E::isLeaf)
+			return mpf_cmp_si(e.pointer(), value);
+
+		typename E::scratch_type t;
+		e.evaluate(*t);
+		return mpf_cmp_si(*t, value);
+	}
+
+	template <typename E>
+	int compare(const E& e, double value)
+	{
+		if (E::isLeaf)
+			return mpf_cmp_d(e.pointer(), value);
+
+		typename E::scratch_type t;
+		e.evaluate(*t);
+		return mpf_cmp_d(*t, value);
+	}
+}
+
+// Operators, for mpfreal, mpfreal_fixed and expressions of them only
+
+template <typename L, typename R>
+inline mpfexpr::Binary<mpfexpr::AddOp, typename mpfexpr::Traits<L>::node, typename mpfexpr::Traits<R>::node>
+operator + (const L& l, const R& r)
+{
+	typedef typename mpfexpr::Traits<L>::node LeftNode;
+	typedef typename mpfexpr::Traits<R>::node RightNode;
+	return mpfexpr::Binary<mpfexpr::AddOp, LeftNode, RightNode>(LeftNode(l), RightNode(r));
+}
+
+template <typename L, typename R>
+inline mpfexpr::Binary<mpfexpr::SubOp, typename mpfexpr::Traits<L>::node, typename mpfexpr::Traits<R>::node>
+operator - (const L& l, const R& r)
+{
+	typedef typename mpfexpr::Traits<L>::node LeftNode;
+	typedef typename mpfexpr::Traits<R>::node RightNode;
+	return mpfexpr::Binary<mpfexpr::SubOp, LeftNode, RightNode>(LeftNode(l), RightNode(r));
+}
+
+template <typename L, typename R>
+inline mpfexpr::Binary<mpfexpr::MulOp, typename mpfexpr::Traits<L>::node, typename mpfexpr::Traits<R>::node>
+operator * (const L& l, const R& r)
+{
+	typedef typename mpfexpr::Traits<L>::node LeftNode;
+	typedef typename mpfexpr::Traits<R>::node RightNode;
+	return mpfexpr::Binary<mpfexpr::MulOp, LeftNode, RightNode>(LeftNode(l), RightNode(r));
+}
+
+// e * 2^k
+template <typename E>
+inline mpfexpr::Mul2k<typename mpfexpr::Traits<E>::node> mul2k(const E& e, unsigned long k)
+{
+	typedef typename mpfexpr::Traits<E>::node Node;
+	return mpfexpr::Mul2k<Node>(Node(e), k);
+}
+
+// Comparisons with a constant
+
+#define MPFEXPR_COMPARISON(op, Constant) \
+template <typename E> \
+inline typename mpfexpr::Enable<bool, typename mpfexpr::Traits<E>::node>::type operator op (const E& e, Constant value) \
+{ \
+	typedef typename mpfexpr::Traits<E>::node Node; \
+	return mpfexpr::compare(Node(e), value) op 0; \
+}
+
+MPFEXPR_COMPARISON(<, int)
+MPFEXPR_COMPARISON(>, int)
+MPFEXPR_COMPARISON(<=, int)
+MPFEXPR_COMPARISON(>=, int)
+MPFEXPR_COMPARISON(<, double)
+MPFEXPR_COMPARISON(>, double)
+MPFEXPR_COMPARISON(<=, double)
+MPFEXPR_COMPARISON(>=, double)
+
+#undef MPFEXPR_COMPARISON
+
+#endif
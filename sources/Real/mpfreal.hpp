@@ -26,6 +26,10 @@
 #pragma once
 
 #include <mpir/gmp.h>
+#include "floatexp.hpp"
+#include "doubledouble.hpp"
+#include "quaddouble.hpp"
+#include "mpfexpr.hpp"
 
 class mpfreal
 {
@@ -40,14 +44,62 @@ public:
 	const mpf_ptr operator*() const; 
 
 	template <class T>
-	T get();
+	T get() const;
 
 	template <>
-	double get()
+	double get() const
 	{
 		return mpf_get_d(mImpl);
 	}
 
+	template <>
+	float get() const
+	{
+		return float(mpf_get_d(mImpl));
+	}
+
+	template <>
+	floatexp get() const
+	{
+		signed long int exponent;
+		const double mantissa = mpf_get_d_2exp(&exponent, mImpl);
+		return floatexp(mantissa, exponent);
+	}
+
+	template <>
+	doubledouble get() const
+	{
+		mpf_t low;
+		mpf_init2(low, mpf_get_prec(mImpl));
+		const double high = mpf_get_d(mImpl);
+		mpf_set_d(low, high);
+		mpf_sub(low, mImpl, low);
+		const doubledouble result(high, mpf_get_d(low));
+		mpf_clear(low);
+		return result;
+	}
+
+	template <>
+	quaddouble get() const
+	{
+		mpf_t rest, part;
+		mpf_init2(rest, mpf_get_prec(mImpl));
+		mpf_init2(part, 64);
+		mpf_set(rest, mImpl);
+
+		double parts[4];
+		for (int i = 0; i < 4; ++i)
+		{
+			parts[i] = mpf_get_d(rest);
+			mpf_set_d(part, parts[i]);
+			mpf_sub(rest, rest, part);
+		}
+
+		mpf_clear(part);
+		mpf_clear(rest);
+		return quaddouble(parts[0], parts[1], parts[2], parts[3]);
+	}
+
 
 	void operator=(const mpfreal& val)
 	{
@@ -59,6 +111,44 @@ public:
 		mpf_set_d(this->mImpl, val);
 	}
 
+	void operator=(const floatexp& val)
+	{
+		if (val.isZero())
+		{
+			mpf_set_ui(this->mImpl, 0);
+			return;
+		}
+
+		mpf_set_d(this->mImpl, val.mantissa());
+		if (val.exponent() >= 0)
+			mpf_mul_2exp(this->mImpl, this->mImpl, (mp_bitcnt_t)val.exponent());
+		else
+			mpf_div_2exp(this->mImpl, this->mImpl, (mp_bitcnt_t)-val.exponent());
+	}
+
+	void operator=(const doubledouble& val)
+	{
+		mpf_t low;
+		mpf_init2(low, 64);
+		mpf_set_d(low, val.low());
+		mpf_set_d(this->mImpl, val.high());
+		mpf_add(this->mImpl, this->mImpl, low);
+		mpf_clear(low);
+	}
+
+	void operator=(const quaddouble& val)
+	{
+		mpf_t part;
+		mpf_init2(part, 64);
+		mpf_set_d(this->mImpl, val[0]);
+		for (int i = 1; i < 4; ++i)
+		{
+			mpf_set_d(part, val[i]);
+			mpf_add(this->mImpl, this->mImpl, part);
+		}
+		mpf_clear(part);
+	}
+
 	void operator=(int val)
 	{
 		mpf_set_si(this->mImpl, val);
@@ -68,4 +158,11 @@ public:
 	{
 		mpf_set_str(this->mImpl, val, 10);
 	}
+
+	// Evaluate an expression of mpf numbers straight into this one
+	template <class E>
+	typename mpfexpr::Enable<void, typename mpfexpr::Traits<E>::assignable>::type operator=(const E& expression)
+	{
+		typename mpfexpr::Traits<E>::node(expression).evaluate(this->mImpl);
+	}
 };
\ No newline at end of file
@@ -0,0 +1,143 @@
+/*
+ *  mpfreal_fixed.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef MPFREAL_FIXED_HPP
+#define MPFREAL_FIXED_HPP
+
+#include <mpir/gmp.h>
+#include <cstring>
+#include "floatexp.hpp"
+#include "mpfexpr.hpp"
+
+// mpf of at most Bits bits whose limbs live inside the object: _mp_d
+// points to an array member instead of the heap. Creating, copying or
+// destroying one never allocates, so it can be a per pixel temporary or
+// sit in a std::vector, and moving it is a plain copy of the limbs.
+// It works with every mpf_* function through operator*, at the default
+// precision capped to Bits, so that it computes exactly what an mpfreal
+// would. Never call mpf_clear or mpf_set_prec on it.
+template <unsigned Bits>
+class mpfreal_fixed
+{
+public:
+	// Same rounding of bits to limbs as mpf_init2, plus the extra limb
+	// mpf writes to
+	static const int Precision = (Bits + 2 * GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+
+	// Whether the current default precision fits
+	static bool fits()
+	{
+		return mpf_get_default_prec() <= Bits;
+	}
+
+	mpfreal_fixed()
+	{
+		_init(_defaultPrecision());
+	}
+
+	mpfreal_fixed(const mpfreal_fixed& val)
+	{
+		_init(val.m_impl._mp_prec);
+		_copy(val);
+	}
+
+	mpfreal_fixed& operator=(const mpfreal_fixed& val)
+	{
+		if (this != &val)
+		{
+			m_impl._mp_prec = val.m_impl._mp_prec;
+			_copy(val);
+		}
+		return *this;
+	}
+
+	const mpf_ptr operator*() const
+	{
+		return (mpf_ptr)&m_impl;
+	}
+
+	void operator=(mpf_srcptr val)
+	{
+		mpf_set(&m_impl, val);
+	}
+
+	void operator=(double val)
+	{
+		mpf_set_d(&m_impl, val);
+	}
+
+	void operator=(int val)
+	{
+		mpf_set_si(&m_impl, val);
+	}
+
+	// Evaluate an expression of mpf numbers straight into this one
+	template <class E>
+	typename mpfexpr::Enable<void, typename mpfexpr::Traits<E>::assignable>::type operator=(const E& expression)
+	{
+		typename mpfexpr::Traits<E>::node(expression).evaluate(&m_impl);
+	}
+
+	double toDouble() const
+	{
+		return mpf_get_d(&m_impl);
+	}
+
+	floatexp toFloatexp() const
+	{
+		signed long int exponent;
+		const double mantissa = mpf_get_d_2exp(&exponent, &m_impl);
+		return floatexp(mantissa, exponent);
+	}
+
+private:
+	static int _defaultPrecision()
+	{
+		const int precision = (int)((mpf_get_default_prec() + 2 * GMP_NUMB_BITS - 1) / GMP_NUMB_BITS);
+		return (precision < Precision) ? precision : Precision;
+	}
+
+	void _init(int precision)
+	{
+		m_impl._mp_prec = precision;
+		m_impl._mp_size = 0;
+		m_impl._mp_exp = 0;
+		m_impl._mp_d = m_limbs;
+	}
+
+	// Only the limbs in use are copied, _mp_d keeps pointing to ours
+	void _copy(const mpfreal_fixed& val)
+	{
+		const int size = (val.m_impl._mp_size < 0) ? -val.m_impl._mp_size : val.m_impl._mp_size;
+		m_impl._mp_size = val.m_impl._mp_size;
+		m_impl._mp_exp = val.m_impl._mp_exp;
+		std::memcpy(m_limbs, val.m_limbs, size * sizeof(mp_limb_t));
+	}
+
+	__mpf_struct m_impl;
+	mp_limb_t m_limbs[Precision + 1];
+};
+
+#endif
@@ -0,0 +1,279 @@
+/*
+ *  quaddouble.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef QUADDOUBLE_HPP
+#define QUADDOUBLE_HPP
+
+#include "doubledouble.hpp"
+
+// Unevaluated sum of four doubles, x0 + x1 + x2 + x3 with each term
+// below half an ulp of the previous one: about 212 bits of mantissa.
+// Addition and product are the "sloppy" variants of Hida, Li & Bailey,
+// accurate to a few ulps of the last term, which is all an escape time
+// iteration needs. Like doubledouble, never build this with fast math.
+class quaddouble
+{
+public:
+	quaddouble() { x[0] = x[1] = x[2] = x[3] = 0; }
+	quaddouble(double a) { x[0] = a; x[1] = x[2] = x[3] = 0; }
+	quaddouble(int a) { x[0] = a; x[1] = x[2] = x[3] = 0; }
+	quaddouble(double a0, double a1, double a2, double a3)
+	{
+		double c4 = 0;
+		renormalize(a0, a1, a2, a3, c4);
+		x[0] = a0; x[1] = a1; x[2] = a2; x[3] = a3;
+	}
+
+	double operator[](int i) const { return x[i]; }
+	double toDouble() const { return x[0] + (x[1] + (x[2] + x[3])); }
+
+	// Arithmetic
+
+	friend quaddouble operator - (const quaddouble& a)
+	{
+		return make(-a.x[0], -a.x[1], -a.x[2], -a.x[3]);
+	}
+
+	friend quaddouble operator + (const quaddouble& a, const quaddouble& b)
+	{
+		double s0, s1, s2, s3;
+		double t0, t1, t2, t3;
+
+		doubledouble::twoSum(a.x[0], b.x[0], s0, t0);
+		doubledouble::twoSum(a.x[1], b.x[1], s1, t1);
+		doubledouble::twoSum(a.x[2], b.x[2], s2, t2);
+		doubledouble::twoSum(a.x[3], b.x[3], s3, t3);
+
+		doubledouble::twoSum(s1, t0, s1, t0);
+		threeSum(s2, t0, t1);
+		threeSum2(s3, t0, t2);
+		t0 = t0 + t1 + t3;
+
+		renormalize(s0, s1, s2, s3, t0);
+		return make(s0, s1, s2, s3);
+	}
+
+	friend quaddouble operator - (const quaddouble& a, const quaddouble& b)
+	{
+		return a + (-b);
+	}
+
+	friend quaddouble operator * (const quaddouble& a, const quaddouble& b)
+	{
+		double p0, p1, p2, p3, p4, p5;
+		double q0, q1, q2, q3, q4, q5;
+		double s0, s1, s2;
+		double t0, t1;
+
+		doubledouble::twoProd(a.x[0], b.x[0], p0, q0);
+		doubledouble::twoProd(a.x[0], b.x[1], p1, q1);
+		doubledouble::twoProd(a.x[1], b.x[0], p2, q2);
+		doubledouble::twoProd(a.x[0], b.x[2], p3, q3);
+		doubledouble::twoProd(a.x[1], b.x[1], p4, q4);
+		doubledouble::twoProd(a.x[2], b.x[0], p5, q5);
+
+		// Order eps terms
+		threeSum(p1, p2, q0);
+
+		// Order eps^2 terms: (p2, q1, q2) + (p3, p4, p5)
+		threeSum(p2, q1, q2);
+		threeSum(p3, p4, p5);
+
+		doubledouble::twoSum(p2, p3, s0, t0);
+		doubledouble::twoSum(q1, p4, s1, t1);
+		s2 = q2 + p5;
+		doubledouble::twoSum(s1, t0, s1, t0);
+		s2 += t0 + t1;
+
+		// Order eps^3 terms, plain double is enough
+		s1 += a.x[0] * b.x[3] + a.x[1] * b.x[2] + a.x[2] * b.x[1] + a.x[3] * b.x[0] + q0 + q3 + q4 + q5;
+
+		renormalize(p0, p1, s0, s1, s2);
+		return make(p0, p1, s0, s1);
+	}
+
+	quaddouble& operator += (const quaddouble& a) { return *this = *this + a; }
+	quaddouble& operator -= (const quaddouble& a) { return *this = *this - a; }
+	quaddouble& operator *= (const quaddouble& a) { return *this = *this * a; }
+
+	// THIS * 2, exact
+	quaddouble mul2() const
+	{
+		return make(2.0 * x[0], 2.0 * x[1], 2.0 * x[2], 2.0 * x[3]);
+	}
+
+	// a * a with the symmetric cross products computed once
+	friend quaddouble sqr(const quaddouble& a)
+	{
+		double p0, p1, p2, p3, p4, p5;
+		double q0, q1, q2, q3;
+		double s0, s1;
+		double t0, t1;
+
+		doubledouble::twoProd(a.x[0], a.x[0], p0, q0);
+		doubledouble::twoProd(2.0 * a.x[0], a.x[1], p1, q1);
+		doubledouble::twoProd(2.0 * a.x[0], a.x[2], p2, q2);
+		doubledouble::twoProd(a.x[1], a.x[1], p3, q3);
+
+		doubledouble::twoSum(q0, p1, p1, q0);
+
+		doubledouble::twoSum(q0, q1, q0, q1);
+		doubledouble::twoSum(p2, p3, p2, p3);
+
+		doubledouble::twoSum(q0, p2, s0, t0);
+		doubledouble::twoSum(q1, p3, s1, t1);
+
+		doubledouble::twoSum(s1, t0, s1, t0);
+		t0 += t1;
+
+		doubledouble::quickTwoSum(s1, t0, s1, t0);
+		doubledouble::quickTwoSum(s0, s1, p2, t1);
+		doubledouble::quickTwoSum(t1, t0, p3, q0);
+
+		// Order eps^3 terms
+		p4 = 2.0 * a.x[0] * a.x[3];
+		p5 = 2.0 * a.x[1] * a.x[2];
+
+		doubledouble::twoSum(p4, p5, p4, p5);
+		doubledouble::twoSum(q2, q3, q2, q3);
+
+		doubledouble::twoSum(p4, q2, t0, t1);
+		t1 = t1 + p5 + q3;
+
+		doubledouble::twoSum(p3, t0, p3, p4);
+		p4 = p4 + q0 + t1;
+
+		renormalize(p0, p1, p2, p3, p4);
+		return make(p0, p1, p2, p3);
+	}
+
+	// Comparisons
+
+	friend bool operator < (const quaddouble& a, const quaddouble& b)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			if (a.x[i] != b.x[i])
+				return a.x[i] < b.x[i];
+		}
+		return a.x[3] < b.x[3];
+	}
+
+	friend bool operator > (const quaddouble& a, const quaddouble& b) { return b < a; }
+	friend bool operator <= (const quaddouble& a, const quaddouble& b) { return !(b < a); }
+	friend bool operator >= (const quaddouble& a, const quaddouble& b) { return !(a < b); }
+
+private:
+	static quaddouble make(double a0, double a1, double a2, double a3)
+	{
+		quaddouble r;
+		r.x[0] = a0; r.x[1] = a1; r.x[2] = a2; r.x[3] = a3;
+		return r;
+	}
+
+	// a + b + c = a' + b' + c' with a' the rounded sum
+	static void threeSum(double& a, double& b, double& c)
+	{
+		double t1, t2, t3;
+		doubledouble::twoSum(a, b, t1, t2);
+		doubledouble::twoSum(c, t1, a, t3);
+		doubledouble::twoSum(t2, t3, b, c);
+	}
+
+	// Same, only the first two terms are kept
+	static void threeSum2(double& a, double& b, double c)
+	{
+		double t1, t2, t3;
+		doubledouble::twoSum(a, b, t1, t2);
+		doubledouble::twoSum(c, t1, a, t3);
+		b = t2 + t3;
+	}
+
+	// Bring c0..c4 back to four non overlapping terms in c0..c3
+	static void renormalize(double& c0, double& c1, double& c2, double& c3, double& c4)
+	{
+		double s0, s1, s2 = 0, s3 = 0;
+
+		doubledouble::quickTwoSum(c3, c4, s0, c4);
+		doubledouble::quickTwoSum(c2, s0, s0, c3);
+		doubledouble::quickTwoSum(c1, s0, s0, c2);
+		doubledouble::quickTwoSum(c0, s0, c0, c1);
+
+		s0 = c0;
+		s1 = c1;
+
+		if (s1 != 0)
+		{
+			doubledouble::quickTwoSum(s1, c2, s1, s2);
+			if (s2 != 0)
+			{
+				doubledouble::quickTwoSum(s2, c3, s2, s3);
+				if (s3 != 0)
+					s3 += c4;
+				else
+					s2 += c4;
+			}
+			else
+			{
+				doubledouble::quickTwoSum(s1, c3, s1, s2);
+				if (s2 != 0)
+					doubledouble::quickTwoSum(s2, c4, s2, s3);
+				else
+					doubledouble::quickTwoSum(s1, c4, s1, s2);
+			}
+		}
+		else
+		{
+			doubledouble::quickTwoSum(s0, c2, s0, s1);
+			if (s1 != 0)
+			{
+				doubledouble::quickTwoSum(s1, c3, s1, s2);
+				if (s2 != 0)
+					doubledouble::quickTwoSum(s2, c4, s2, s3);
+				else
+					doubledouble::quickTwoSum(s1, c4, s1, s2);
+			}
+			else
+			{
+				doubledouble::quickTwoSum(s0, c3, s0, s1);
+				if (s1 != 0)
+					doubledouble::quickTwoSum(s1, c4, s1, s2);
+				else
+					doubledouble::quickTwoSum(s0, c4, s0, s1);
+			}
+		}
+
+		c0 = s0;
+		c1 = s1;
+		c2 = s2;
+		c3 = s3;
+	}
+
+	double x[4];
+};
+
+inline double toDouble(const quaddouble& a) { return a.toDouble(); }
+
+#endif
@@ -0,0 +1,117 @@
+/*
+ *  BilinearApproximation.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "BilinearApproximation.hpp"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+	// Relative size of the dropped dz^2 term we accept. Looser values
+	// visibly move the escape iteration of pixels close to the set.
+	const double precision = 1.0 / (1LL << 40);
+
+	// Step X then step Y
+	BLAStep merge(const BLAStep& x, const BLAStep& y, const floatexp& dcRadius)
+	{
+		BLAStep step;
+		step.ax = y.ax * x.ax - y.ay * x.ay;
+		step.ay = y.ax * x.ay + y.ay * x.ax;
+		step.bx = y.ax * x.bx - y.ay * x.by + y.bx;
+		step.by = y.ax * x.by + y.ay * x.bx + y.by;
+		step.length = x.length + y.length;
+
+		// dz must stay valid for X, and once X is applied, for Y as well
+		const floatexp xRadius = sqrt(x.radius2);
+		const floatexp yRadius = sqrt(y.radius2);
+		const floatexp xA = sqrt(x.ax * x.ax + x.ay * x.ay);
+		const floatexp xB = sqrt(x.bx * x.bx + x.by * x.by);
+		floatexp radius = xRadius;
+
+		if (xA > 0)
+			radius = std::min(radius, std::max(floatexp(), (yRadius - xB * dcRadius) / xA));
+
+		step.radius2 = radius * radius;
+		return step;
+	}
+}
+
+BilinearApproximation::BilinearApproximation() :
+m_levels()
+{
+}
+
+void BilinearApproximation::compute(const ReferenceOrbit& orbit, const floatexp& dcRadius)
+{
+	m_levels.clear();
+
+	const unsigned lastIteration = orbit.getLastIteration();
+	if (lastIteration < 2)
+		return;
+
+	// Single iterations from Z(1) to Z(last): A = 2 Z(n), B = 1
+	m_levels.push_back(std::vector<BLAStep>());
+	std::vector<BLAStep>& singles = m_levels.back();
+	singles.reserve(lastIteration - 1);
+
+	for (unsigned n = 1; n < lastIteration; ++n)
+	{
+		const floatexp zNorm = std::sqrt(orbit[n].x * orbit[n].x + orbit[n].y * orbit[n].y);
+
+		BLAStep step;
+		step.ax = 2.0 * orbit[n].x;
+		step.ay = 2.0 * orbit[n].y;
+		step.bx = 1.0;
+		step.by = 0.0;
+		step.length = 1;
+
+		const floatexp radius = std::max(floatexp(), (zNorm - dcRadius) / (2.0 * zNorm + 1.0)) * precision;
+		step.radius2 = radius * radius;
+		singles.push_back(step);
+	}
+
+	while (m_levels.back().size() > 1)
+	{
+		const std::vector<BLAStep>& previous = m_levels.back();
+		std::vector<BLAStep> merged;
+		merged.reserve((previous.size() + 1) / 2);
+
+		for (size_t i = 0; i + 1 < previous.size(); i += 2)
+			merged.push_back(merge(previous[i], previous[i + 1], dcRadius));
+
+		if (previous.size() % 2 == 1)
+			merged.push_back(previous.back());
+
+		m_levels.push_back(std::vector<BLAStep>());
+		m_levels.back().swap(merged);
+	}
+}
+
+size_t BilinearApproximation::getMemoryUsage() const
+{
+	size_t bytes = 0;
+	for (size_t level = 0; level < m_levels.size(); ++level)
+		bytes += m_levels[level].capacity() * sizeof(BLAStep);
+	return bytes;
+}
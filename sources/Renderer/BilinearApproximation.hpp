@@ -0,0 +1,97 @@
+/*
+ *  BilinearApproximation.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef BILINEAR_APPROXIMATION_HPP
+#define BILINEAR_APPROXIMATION_HPP
+
+#include <vector>
+#include <cstddef>
+#include "ReferenceOrbit.hpp"
+#include "../Real/floatexp.hpp"
+
+// l iterations of the perturbation collapsed into
+//     dz(n+l) = A * dz(n) + B * dc
+// which holds as long as |dz(n)| stays below the validity radius.
+// A is the product of 2 Z over the step and B gathers dc's share: both
+// leave double range on long steps, as does the radius on deep zooms.
+struct BLAStep
+{
+	floatexp ax, ay;
+	floatexp bx, by;
+	floatexp radius2;
+	unsigned length;
+};
+
+// Table of BLA steps: level 0 holds one step per reference iteration,
+// level k merges pairs of level k-1 steps and spans 2^k iterations.
+class BilinearApproximation
+{
+public:
+	BilinearApproximation();
+
+	// dcRadius is the largest |dc| of the frame
+	void compute(const ReferenceOrbit& orbit, const floatexp& dcRadius);
+
+	// Longest step starting at reference iteration n that accepts dz and
+	// spans at most maxLength iterations, or NULL if there is none
+	// better than a regular perturbation iteration.
+	// A merged step is never valid where its first half is not, so the
+	// search climbs the levels and stops at the first rejection.
+	const BLAStep* lookup(unsigned n, const floatexp& dzNorm, unsigned maxLength) const
+	{
+		if (n < 1)
+			return NULL;
+
+		const unsigned offset = n - 1;
+		const BLAStep* found = NULL;
+
+		for (size_t level = 1; level < m_levels.size(); ++level)
+		{
+			if ((offset & ((1u << level) - 1)) != 0)
+				break;
+
+			const std::vector<BLAStep>& steps = m_levels[level];
+			const unsigned index = offset >> level;
+
+			if (index >= steps.size())
+				break;
+
+			const BLAStep& step = steps[index];
+			if (step.length > maxLength || dzNorm >= step.radius2)
+				break;
+
+			found = &step;
+		}
+
+		return found;
+	}
+
+	size_t getMemoryUsage() const;
+
+private:
+	std::vector< std::vector<BLAStep> > m_levels;
+};
+
+#endif
@@ -0,0 +1,174 @@
+/*
+ *  CoordinateGenerator.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "CoordinateGenerator.hpp"
+#include <algorithm>
+#include <climits>
+
+namespace
+{
+	// Bits of the step kept when the mpf precision is too low to put
+	// the whole frame on the grid
+	const long stepBits = 32;
+
+	// Exponent e with |value| < 2^e, or LONG_MIN for 0
+	long magnitudeExponent(mpf_srcptr value)
+	{
+		if (mpf_sgn(value) == 0)
+			return LONG_MIN;
+
+		signed long int exponent;
+		mpf_get_d_2exp(&exponent, value);
+		return exponent;
+	}
+
+	// value = round(value / 2^k) * 2^k
+	void roundToGrid(mpf_ptr value, long k)
+	{
+		if (k >= 0)
+			mpf_div_2exp(value, value, (mp_bitcnt_t)k);
+		else
+			mpf_mul_2exp(value, value, (mp_bitcnt_t)-k);
+
+		const bool negative = (mpf_sgn(value) < 0);
+		mpf_abs(value, value);
+
+		mpf_t half;
+		mpf_init2(half, 64);
+		mpf_set_d(half, 0.5);
+		mpf_add(value, value, half);
+		mpf_floor(value, value);
+		mpf_clear(half);
+
+		if (negative)
+			mpf_neg(value, value);
+
+		if (k >= 0)
+			mpf_mul_2exp(value, value, (mp_bitcnt_t)k);
+		else
+			mpf_div_2exp(value, value, (mp_bitcnt_t)-k);
+	}
+}
+
+const double CoordinateGenerator::FractalLeft = -2.1;
+const double CoordinateGenerator::FractalBottom = -1.2;
+
+CoordinateGenerator::CoordinateGenerator() :
+m_columns(),
+m_rows(),
+m_step()
+{
+}
+
+void CoordinateGenerator::compute(unsigned width, unsigned heigth, const mpfreal& zoom, const mpfreal& x, const mpfreal& y)
+{
+	const mp_bitcnt_t precision = mpf_get_default_prec();
+
+	// Origin and step are worked out with a few spare bits, they are
+	// rounded to the grid afterwards
+	mpf_t zoom_y, tmp, originX, originY, step;
+	mpf_init2(zoom_y, precision + 64);
+	mpf_init2(tmp, precision + 64);
+	mpf_init2(originX, precision + 64);
+	mpf_init2(originY, precision + 64);
+	mpf_init2(step, precision + 64);
+
+	mpf_set_d(tmp, double(heigth) / 2.4);
+	mpf_mul(zoom_y, *zoom, tmp); // zoom_y = m_zoom * double(m_pixelBufferHeigth) / (fractal_top - fractal_bottom)
+
+	mpf_mul_ui(originX, *zoom, width);
+	mpf_mul(originX, originX, *x); // originX = fractal_width * m_x
+	mpf_set_si(tmp, (int)width / 2);
+	mpf_sub(originX, originX, tmp); // originX = fractal_width * m_x - (m_pixelBufferWidth / 2)
+	mpf_div(originX, originX, zoom_y);
+	mpf_set_d(tmp, FractalLeft);
+	mpf_add(originX, originX, tmp); // originX = originX / zoom_y + FractalLeft
+
+	mpf_mul_ui(originY, *zoom, heigth);
+	mpf_mul(originY, originY, *y); // originY = fractal_height * m_y
+	mpf_set_si(tmp, (int)heigth / 2);
+	mpf_sub(originY, originY, tmp); // originY = fractal_height * m_y - (m_pixelBufferHeigth / 2)
+	mpf_div(originY, originY, zoom_y);
+	mpf_set_d(tmp, FractalBottom);
+	mpf_add(originY, originY, tmp); // originY = originY / zoom_y + FractalBottom
+
+	mpf_ui_div(step, 1, zoom_y); // step = 1 / zoom_y
+
+	// Bound the coordinates of the frame by 2^top: the origin and the
+	// far end of both axes, plus the span of an axis around 0
+	const unsigned pixels = std::max(width, heigth);
+	const long stepExponent = magnitudeExponent(step);
+	long top = stepExponent + 1;
+	for (unsigned span = pixels; span > 0; span >>= 1)
+		++top;
+
+	top = std::max(top, magnitudeExponent(originX) + 1);
+	top = std::max(top, magnitudeExponent(originY) + 1);
+
+	// Grid spacing 2^grid: coordinates below 2^top fit in the mpf
+	// precision, unless that leaves too few bits to the step
+	const long grid = std::min(top - (long)precision, stepExponent - stepBits);
+
+	roundToGrid(originX, grid);
+	roundToGrid(originY, grid);
+	roundToGrid(step, grid);
+
+	// The running coordinate holds every bit between 2^top and the grid,
+	// adding the step to it never rounds
+	mpf_t accumulator;
+	mpf_init2(accumulator, (mp_bitcnt_t)(top - grid) + 64);
+
+	_generate(m_columns, width, originX, step, accumulator);
+	_generate(m_rows, heigth, originY, step, accumulator);
+	if (mpf_get_prec(*m_step) != precision)
+		mpf_set_prec(*m_step, precision);
+	mpf_set(*m_step, step);
+
+	mpf_clear(accumulator);
+	mpf_clear(step);
+	mpf_clear(originY);
+	mpf_clear(originX);
+	mpf_clear(tmp);
+	mpf_clear(zoom_y);
+}
+
+void CoordinateGenerator::_generate(std::vector<mpfreal>& coordinates, unsigned count, mpf_srcptr origin, mpf_srcptr step,
+									mpf_ptr accumulator) const
+{
+	coordinates.resize(count);
+
+	// Coordinates kept from a previous frame follow the precision of
+	// this one
+	const mp_bitcnt_t precision = mpf_get_default_prec();
+
+	mpf_set(accumulator, origin);
+	for (unsigned i = 0; i < count; ++i)
+	{
+		if (mpf_get_prec(*coordinates[i]) != precision)
+			mpf_set_prec(*coordinates[i], precision);
+		mpf_set(*coordinates[i], accumulator);
+		mpf_add(accumulator, accumulator, step);
+	}
+}
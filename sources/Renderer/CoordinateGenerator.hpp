@@ -0,0 +1,86 @@
+/*
+ *  CoordinateGenerator.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef COORDINATE_GENERATOR_HPP
+#define COORDINATE_GENERATOR_HPP
+
+#include <vector>
+#include "../Real/mpfreal.hpp"
+
+// Complex plane coordinates of the pixels of a frame, shared by the
+// renderers: pixel (i, j) maps to c = (getX(i), getY(j)) with
+// getX(i) = getX(0) + i * getStep(), and the same for rows.
+// Columns and rows are computed once per frame, by adding the step to
+// a running coordinate. The origin and step are first rounded onto a
+// common power of two grid, fine enough for the mpf precision in use,
+// so that every addition is exact and no error builds up across the
+// frame.
+class CoordinateGenerator
+{
+public:
+	// Bottom left corner of the view at zoom 1, the origin every engine
+	// maps the pixels from
+	static const double FractalLeft;
+	static const double FractalBottom;
+
+	CoordinateGenerator();
+
+	void compute(unsigned width, unsigned heigth, const mpfreal& zoom, const mpfreal& x, const mpfreal& y);
+
+	unsigned getWidth() const { return unsigned(m_columns.size()); }
+	unsigned getHeigth() const { return unsigned(m_rows.size()); }
+
+	const mpfreal& getX(unsigned image_x) const { return m_columns[image_x]; }
+	const mpfreal& getY(unsigned image_y) const { return m_rows[image_y]; }
+	const mpfreal& getStep() const { return m_step; }
+
+	// Column and row coordinates converted to one of the other
+	// representations, for the engines that do not iterate in mpf
+	template <typename T>
+	void getColumns(std::vector<T>& columns) const
+	{
+		columns.resize(m_columns.size());
+		for (size_t i = 0; i < m_columns.size(); ++i)
+			columns[i] = m_columns[i].get<T>();
+	}
+
+	template <typename T>
+	void getRows(std::vector<T>& rows) const
+	{
+		rows.resize(m_rows.size());
+		for (size_t i = 0; i < m_rows.size(); ++i)
+			rows[i] = m_rows[i].get<T>();
+	}
+
+private:
+	void _generate(std::vector<mpfreal>& coordinates, unsigned count, mpf_srcptr origin, mpf_srcptr step,
+				   mpf_ptr accumulator) const;
+
+	std::vector<mpfreal> m_columns;
+	std::vector<mpfreal> m_rows;
+	mpfreal m_step;
+};
+
+#endif
@@ -0,0 +1,431 @@
+/*
+ *  EscapeTime.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef ESCAPE_TIME_HPP
+#define ESCAPE_TIME_HPP
+
+#include <vector>
+#include <cmath>
+#include "../Real/mpfreal.hpp"
+#include "../Real/doubledouble.hpp"
+#include "../Real/quaddouble.hpp"
+#include "../Real/FPReal.hpp"
+
+// The escape time loop, its bailout and its coloring, written once for
+// every number type. A type takes part through EscapeTimeTraits:
+//
+//   typedef ... Real;        iterated values
+//   typedef ... Coordinate;  pixel coordinates, assignable to Real
+//   static void mul(Real& z, const Real& x, const Real& y);
+//       z = x * y
+//   static void sqrDiffAdd(Real& z, Real& x2, Real& y2, const Real& x, const Real& y, const Coordinate& c);
+//       x2 = x^2, y2 = y^2, z = x2 - y2 + c; z may be x
+//   static void mul2Add(Real& z, const Real& x, const Coordinate& c);
+//       z = 2 * x + c
+//   static bool escaped(const Real& x2, const Real& y2);
+//       x2 + y2 > 4
+//   static double toDouble(const Coordinate& c);
+//       c to within a few double ulps, for the interior test
+//   static bool periodic(const Real& zx, const Real& zy, const Real& px, const Real& py);
+//       z back on the saved point p: both coordinates within 16 ulps
+//       of 1 in the precision of the type for the wide types, equal
+//       for float and double
+//
+// The generic traits spell these with operators, which suits mpfreal
+// and its expression templates; the other types below use their own
+// kernels. Everything is inline, each engine gets its loop compiled for
+// its type.
+
+// Quick rejection for the periodic tests of the wide types: leading
+// doubles 1e-14 apart, a few double ulps of 2 and far more than any of
+// their tolerances, leave z away from p without a full subtraction
+inline bool leadingApart(double z, double p)
+{
+	return std::fabs(z - p) > 1e-14;
+}
+
+template <typename T, typename C = T>
+struct EscapeTimeTraits
+{
+	typedef T Real;
+	typedef C Coordinate;
+
+	static void mul(Real& z, const Real& x, const Real& y) { z = x * y; }
+
+	static void sqrDiffAdd(Real& z, Real& x2, Real& y2, const Real& x, const Real& y, const Coordinate& c)
+	{
+		x2 = x * x;
+		y2 = y * y;
+		z = x2 - y2 + c;
+	}
+
+	static void mul2Add(Real& z, const Real& x, const Coordinate& c) { z = mul2k(x, 1) + c; }
+
+	static bool escaped(const Real& x2, const Real& y2) { return x2 + y2 > 4; }
+
+	static double toDouble(const Coordinate& c) { return c.template get<double>(); }
+
+	static bool periodic(const Real& zx, const Real& zy, const Real& px, const Real& py)
+	{
+		// 16 ulps of 1 at the default precision
+		if (leadingApart(mpf_get_d(*zx), mpf_get_d(*px)) || leadingApart(mpf_get_d(*zy), mpf_get_d(*py)))
+			return false;
+
+		const signed long int exponent = 5 - (signed long int)mpf_get_default_prec();
+		Real difference;
+
+		difference = zx - px;
+		if (!_below(*difference, exponent))
+			return false;
+
+		difference = zy - py;
+		return _below(*difference, exponent);
+	}
+
+private:
+	// |x| < 2^exponent, to within a factor 2
+	static bool _below(mpf_srcptr x, signed long int exponent)
+	{
+		if (mpf_sgn(x) == 0)
+			return true;
+
+		signed long int e;
+		mpf_get_d_2exp(&e, x);
+		return e <= exponent;
+	}
+};
+
+// float and double, x + x being exact
+template <typename T>
+struct EscapeTimeFloatTraits
+{
+	typedef T Real;
+	typedef T Coordinate;
+
+	static void mul(Real& z, Real x, Real y) { z = x * y; }
+
+	static void sqrDiffAdd(Real& z, Real& x2, Real& y2, Real x, Real y, Real c)
+	{
+		x2 = x * x;
+		y2 = y * y;
+		z = x2 - y2 + c;
+	}
+
+	static void mul2Add(Real& z, Real x, Real c) { z = x + x + c; }
+
+	static bool escaped(Real x2, Real y2) { return x2 + y2 > T(4); }
+
+	static double toDouble(Real c) { return c; }
+
+	// Exact: near the cusp and the bulb roots, orbits that escape after a
+	// few thousand iterations move by less than a few float ulps per
+	// step. An orbit back exactly on p repeats forever all the same.
+	static bool periodic(Real zx, Real zy, Real px, Real py) { return zx == px && zy == py; }
+};
+
+template <> struct EscapeTimeTraits<float> : public EscapeTimeFloatTraits<float> {};
+template <> struct EscapeTimeTraits<double> : public EscapeTimeFloatTraits<double> {};
+
+// The high parts are plenty for the escape test
+template <>
+struct EscapeTimeTraits<doubledouble>
+{
+	typedef doubledouble Real;
+	typedef doubledouble Coordinate;
+
+	static void mul(Real& z, const Real& x, const Real& y) { z = x * y; }
+
+	static void sqrDiffAdd(Real& z, Real& x2, Real& y2, const Real& x, const Real& y, const Real& c)
+	{
+		x2 = sqr(x);
+		y2 = sqr(y);
+		z = x2 - y2 + c;
+	}
+
+	static void mul2Add(Real& z, const Real& x, const Real& c) { z = x.mul2() + c; }
+
+	static bool escaped(const Real& x2, const Real& y2) { return x2.high() + y2.high() > 4.0; }
+
+	static double toDouble(const Coordinate& c) { return c.high(); }
+
+	// 16 ulps of 1 in 106 bits
+	static bool periodic(const Real& zx, const Real& zy, const Real& px, const Real& py)
+	{
+		if (leadingApart(zx.high(), px.high()) || leadingApart(zy.high(), py.high()))
+			return false;
+
+		const double tolerance = 3.9e-31;
+		return std::fabs((zx - px).high()) < tolerance && std::fabs((zy - py).high()) < tolerance;
+	}
+};
+
+// The leading terms are plenty for the escape test
+template <>
+struct EscapeTimeTraits<quaddouble>
+{
+	typedef quaddouble Real;
+	typedef quaddouble Coordinate;
+
+	static void mul(Real& z, const Real& x, const Real& y) { z = x * y; }
+
+	static void sqrDiffAdd(Real& z, Real& x2, Real& y2, const Real& x, const Real& y, const Real& c)
+	{
+		x2 = sqr(x);
+		y2 = sqr(y);
+		z = x2 - y2 + c;
+	}
+
+	static void mul2Add(Real& z, const Real& x, const Real& c) { z = x.mul2() + c; }
+
+	static bool escaped(const Real& x2, const Real& y2) { return x2[0] + y2[0] > 4.0; }
+
+	static double toDouble(const Coordinate& c) { return c[0]; }
+
+	// 16 ulps of 1 in 212 bits
+	static bool periodic(const Real& zx, const Real& zy, const Real& px, const Real& py)
+	{
+		if (leadingApart(zx[0], px[0]) || leadingApart(zy[0], py[0]))
+			return false;
+
+		const double tolerance = 4.9e-63;
+		return std::fabs((zx - px)[0]) < tolerance && std::fabs((zy - py)[0]) < tolerance;
+	}
+};
+
+// The FPReal friends, out of reach of the traits members of the same name
+template <int N, typename Word>
+inline void escapeTimeMul(FPReal<N, Word>& z, const FPReal<N, Word>& x, const FPReal<N, Word>& y)
+{
+	mul(z, x, y);
+}
+
+template <int N, typename Word>
+inline void escapeTimeSqrDiffAdd(FPReal<N, Word>& z, FPReal<N, Word>& x2, FPReal<N, Word>& y2,
+								 const FPReal<N, Word>& x, const FPReal<N, Word>& y, const FPReal<N, Word>& c)
+{
+	sqrDiffAdd(z, x2, y2, x, y, c);
+}
+
+// The fused FPReal kernels; the squares being positive, the escape test
+// only looks at the words of their sum
+template <int N, typename Word>
+struct EscapeTimeTraits<FPReal<N, Word> >
+{
+	typedef FPReal<N, Word> Real;
+	typedef FPReal<N, Word> Coordinate;
+
+	static void mul(Real& z, const Real& x, const Real& y) { escapeTimeMul(z, x, y); }
+
+	static void sqrDiffAdd(Real& z, Real& x2, Real& y2, const Real& x, const Real& y, const Real& c)
+	{
+		escapeTimeSqrDiffAdd(z, x2, y2, x, y, c);
+	}
+
+	static void mul2Add(Real& z, const Real& x, const Real& c)
+	{
+		z = x;
+		z.mul2k(1);
+		z.add(c);
+	}
+
+	static bool escaped(const Real& x2, const Real& y2)
+	{
+		Real norm(x2);
+		norm.add(y2);
+
+		const int integer = norm.intPart();
+		return integer > 4 || (integer == 4 && !checkZeroWords(N - 1, norm.words() + 1));
+	}
+
+	static double toDouble(const Coordinate& c) { return c.toDouble(); }
+
+	// 16 ulps: every word of the difference zero but the last, and that
+	// one below 16
+	static bool periodic(const Real& zx, const Real& zy, const Real& px, const Real& py)
+	{
+		if (leadingApart(_leading(zx), _leading(px)) || leadingApart(_leading(zy), _leading(py)))
+			return false;
+
+		Real difference(zx);
+		difference.sub(px);
+		if (!checkZeroWords(N - 1, difference.words()) || difference.words()[N - 1] >= 16)
+			return false;
+
+		difference = zy;
+		difference.sub(py);
+		return checkZeroWords(N - 1, difference.words()) && difference.words()[N - 1] < 16;
+	}
+
+private:
+	// The first two words, cheaper than toDouble
+	static double _leading(const Real& x)
+	{
+		const double word = std::ldexp(1.0, -(int)(8 * sizeof(Word)));
+		return x.sgn() * ((double)x.words()[0] + (double)x.words()[1] * word);
+	}
+};
+
+// Closed form interior test: c in the main cardioid or in the period-2
+// bulb never escapes, there is no need to iterate it. The test runs in
+// double whatever the engine iterates in, so it only says yes by a
+// margin well above the rounding of c to double and of the test itself;
+// pixels closer than that to either boundary are iterated as before.
+//   bulb:     |c + 1| < 1/4
+//   cardioid: with p = |c - 1/4|, cx - 1/4 < p - 2 p^2
+// Both sides move by at most a few units per unit of c, the margin
+// covers errors up to about 1e-12 on c.
+inline bool isInMainComponents(double cx, double cy)
+{
+	const double margin = 1e-11;
+
+	// Bounding boxes first, most of a frame is outside of both
+	if (cx < -1.25 || cx > 0.375 || cy < -0.65 || cy > 0.65)
+		return false;
+
+	if (cx < -0.75)
+	{
+		const double bx = cx + 1.0;
+		return std::sqrt(bx * bx + cy * cy) < 0.25 - margin;
+	}
+
+	const double ax = cx - 0.25;
+	const double p = std::sqrt(ax * ax + cy * cy);
+	return p - 2.0 * p * p - ax > margin;
+}
+
+// Splits the count pixels (cx[i], cy) of a row: the ones inside the main
+// cardioid or the period-2 bulb get resolution as their count, the
+// indices of the others, still to iterate, go to outside. Returns the
+// number of interior pixels.
+template <class Traits>
+unsigned findInterior(const typename Traits::Coordinate* cx, const typename Traits::Coordinate& cy, unsigned count,
+					  int resolution, int* counts, std::vector<unsigned>& outside)
+{
+	const double y = Traits::toDouble(cy);
+	unsigned interior = 0;
+
+	outside.clear();
+	for (unsigned i = 0; i < count; ++i)
+	{
+		if (isInMainComponents(Traits::toDouble(cx[i]), y))
+		{
+			counts[i] = resolution;
+			++interior;
+		}
+		else
+			outside.push_back(i);
+	}
+
+	return interior;
+}
+
+// Escape count of the pixel (cx, cy), resolution when it does not escape.
+//
+// Orbits caught in an attracting cycle are told apart with Brent's cycle
+// detection: z is compared with a saved point at every iteration, and
+// the saved point moves on to z after 1, 2, 4, 8... iterations. Once
+// the orbit has settled on a cycle of period p, z comes back on the
+// saved point within the first interval longer than p, and the pixel
+// is inside the set.
+template <class Traits>
+int escapeTime(const typename Traits::Coordinate& cx, const typename Traits::Coordinate& cy, int resolution)
+{
+	typename Traits::Real zx, zy;
+	typename Traits::Real x2, y2, xy;
+	typename Traits::Real px, py;
+
+	zx = cx;
+	zy = cy;
+	px = zx;
+	py = zy;
+
+	int interval = 1;
+	int steps = 0;
+
+	int count;
+	for (count = 0; count < resolution; ++count)
+	{
+		// zx moves on with the squares, the escape test follows on them
+		Traits::mul(xy, zx, zy);
+		Traits::sqrDiffAdd(zx, x2, y2, zx, zy, cx);
+
+		if (Traits::escaped(x2, y2))
+			break;
+
+		Traits::mul2Add(zy, xy, cy);
+
+		if (Traits::periodic(zx, zy, px, py))
+			return resolution;
+
+		if (++steps == interval)
+		{
+			px = zx;
+			py = zy;
+			steps = 0;
+			interval *= 2;
+		}
+	}
+
+	return count;
+}
+
+// Red from the escape count, black inside the set
+inline void setEscapeColor(unsigned char *pixel, int count, int resolution)
+{
+	pixel[0] = (count == resolution) ? 0 : (unsigned char)(count * 255 / resolution);
+	pixel[1] = 0;
+	pixel[2] = 0;
+	pixel[3] = 255;
+}
+
+// The frame of the given column and row coordinates, rows spread over
+// the OpenMP threads. Returns the number of pixels the interior test
+// filled in without iterating.
+template <class Traits>
+unsigned renderEscapeTime(unsigned char *pixelBuffer, unsigned width, unsigned heigth, int resolution,
+						  const std::vector<typename Traits::Coordinate>& columns,
+						  const std::vector<typename Traits::Coordinate>& rows)
+{
+	long long interior = 0;
+
+	#pragma omp parallel for schedule(dynamic) reduction(+:interior)
+	for (int image_y = 0; image_y < (int)heigth; ++image_y)
+	{
+		std::vector<int> counts(width);
+		std::vector<unsigned> outside;
+
+		interior += findInterior<Traits>(&columns[0], rows[image_y], width, resolution, &counts[0], outside);
+
+		for (size_t i = 0; i < outside.size(); ++i)
+			counts[outside[i]] = escapeTime<Traits>(columns[outside[i]], rows[image_y], resolution);
+
+		for (unsigned image_x = 0; image_x < width; ++image_x)
+			setEscapeColor(pixelBuffer + (image_y * width + image_x) * 4, counts[image_x], resolution);
+	}
+
+	return (unsigned)interior;
+}
+
+#endif
@@ -0,0 +1,350 @@
+/*
+ *  FixedPointBatch.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef FIXED_POINT_BATCH_HPP
+#define FIXED_POINT_BATCH_HPP
+
+#include "../Real/MPBase.h"
+
+// Fixed point escape time iteration over a batch of pixels, limb sliced:
+// digit k of every pixel of the batch shares one vector register, one
+// pixel per lane, and carries move lane by lane. A number is K digits of
+// D bits in two's complement, each in a 64-bit lane, the first digit
+// being the integer part. D is 32, the widest product plain SIMD gives,
+// or 52 with the IFMA multiply-add of AVX-512.
+//
+// The kernel is written once over a Lanes type providing, on a Vector of
+// Count lanes of 64 bits:
+//   DigitBits, Count
+//   zero(), set1(uint64), load(const uint64*), store(uint64*, Vector)
+//   add, andv, orv, xorv, sub, shiftLeft<S>, shiftRight<S> (logical)
+//   multiplyAdd(lo, hi, a, b): lo += (a * b) mod 2^D, hi += (a * b) >> D
+//   equal, greater (signed): all ones lanes where true
+//   any(Vector): whether any lane is all ones
+// Each file built with a wider instruction set defines its own Lanes.
+
+namespace FixedPointBatch
+{
+	template <class L, int K>
+	struct Number
+	{
+		typename L::Vector d[K];
+	};
+
+	template <class L>
+	inline typename L::Vector digitMask()
+	{
+		return L::set1((((uint64)1) << L::DigitBits) - 1);
+	}
+
+	// R = A + B + CARRY (0 or 1 in every lane)
+	template <class L, int K>
+	inline void add(Number<L, K>& r, const Number<L, K>& a, const Number<L, K>& b,
+					typename L::Vector carry = L::zero())
+	{
+		const typename L::Vector mask = digitMask<L>();
+		for (int k = K - 1; k >= 0; --k)
+		{
+			const typename L::Vector s = L::add(L::add(a.d[k], b.d[k]), carry);
+			carry = L::template shiftRight<L::DigitBits>(s);
+			r.d[k] = L::andv(s, mask);
+		}
+	}
+
+	// R = A - B, as A + ~B + 1
+	template <class L, int K>
+	inline void sub(Number<L, K>& r, const Number<L, K>& a, const Number<L, K>& b)
+	{
+		const typename L::Vector mask = digitMask<L>();
+		Number<L, K> notB;
+		for (int k = 0; k < K; ++k)
+			notB.d[k] = L::xorv(b.d[k], mask);
+		add(r, a, notB, L::set1(1));
+	}
+
+	// All ones in the lanes where A is negative
+	template <class L, int K>
+	inline typename L::Vector signMask(const Number<L, K>& a)
+	{
+		return L::sub(L::zero(), L::template shiftRight<L::DigitBits - 1>(a.d[0]));
+	}
+
+	// R = -A in the lanes where NEGATE is all ones, A elsewhere
+	template <class L, int K>
+	inline void negateWhere(Number<L, K>& r, const Number<L, K>& a, typename L::Vector negate)
+	{
+		const typename L::Vector mask = digitMask<L>();
+		const typename L::Vector flip = L::andv(negate, mask);
+		typename L::Vector carry = L::template shiftRight<63>(negate);
+		for (int k = K - 1; k >= 0; --k)
+		{
+			const typename L::Vector s = L::add(L::xorv(a.d[k], flip), carry);
+			carry = L::template shiftRight<L::DigitBits>(s);
+			r.d[k] = L::andv(s, mask);
+		}
+	}
+
+	// Column sums of a truncated product back to digits. Column K only
+	// brings its high halves, in acc[K - 1].
+	template <class L, int K>
+	inline void normalize(Number<L, K>& r, typename L::Vector acc[K])
+	{
+		const typename L::Vector mask = digitMask<L>();
+		typename L::Vector carry = L::zero();
+		for (int k = K - 1; k >= 0; --k)
+		{
+			const typename L::Vector s = L::add(acc[k], carry);
+			carry = L::template shiftRight<L::DigitBits>(s);
+			r.d[k] = L::andv(s, mask);
+		}
+	}
+
+	// R = A * B truncated to K digits, A and B positive
+	template <class L, int K>
+	inline void multiply(Number<L, K>& r, const Number<L, K>& a, const Number<L, K>& b)
+	{
+		typename L::Vector acc[K + 1];
+		for (int k = 0; k <= K; ++k)
+			acc[k] = L::zero();
+
+		// acc[k + 1] collects the low halves of column k + 1, acc[k] its
+		// high halves; acc[K] is dropped
+		for (int i = 0; i < K; ++i)
+			for (int j = 0; j < K && i + j <= K; ++j)
+				L::multiplyAdd(acc[i + j], acc[i + j > 0 ? i + j - 1 : K], a.d[i], b.d[j]);
+
+		normalize(r, acc);
+	}
+
+	// R = A * A truncated to K digits, A positive: the cross products
+	// are summed once and doubled
+	template <class L, int K>
+	inline void square(Number<L, K>& r, const Number<L, K>& a)
+	{
+		typename L::Vector acc[K + 1];
+		for (int k = 0; k <= K; ++k)
+			acc[k] = L::zero();
+
+		for (int i = 0; i < K; ++i)
+			for (int j = i + 1; j < K && i + j <= K; ++j)
+				L::multiplyAdd(acc[i + j], acc[i + j > 0 ? i + j - 1 : K], a.d[i], a.d[j]);
+
+		for (int k = 0; k < K; ++k)
+			acc[k] = L::template shiftLeft<1>(acc[k]);
+
+		for (int i = 0; 2 * i <= K && i < K; ++i)
+			L::multiplyAdd(acc[2 * i], acc[i > 0 ? 2 * i - 1 : K], a.d[i], a.d[i]);
+
+		normalize(r, acc);
+	}
+
+	// Lanes where A > 4, A positive
+	template <class L, int K>
+	inline typename L::Vector greaterThanFour(const Number<L, K>& a)
+	{
+		const typename L::Vector four = L::set1(4);
+		typename L::Vector fraction = L::zero();
+		for (int k = 1; k < K; ++k)
+			fraction = L::orv(fraction, a.d[k]);
+
+		const typename L::Vector fractionZero = L::equal(fraction, L::zero());
+		const typename L::Vector above = L::greater(a.d[0], four);
+		const typename L::Vector atFour = L::andv(L::equal(a.d[0], four), L::xorv(fractionZero, L::set1(~(uint64)0)));
+		return L::orv(above, atFour);
+	}
+
+	// Lanes where A and B, cut to their first two digits, are at most one
+	// unit of the second digit apart: near can only hold in those
+	template <class L, int K>
+	inline typename L::Vector nearLeading(const Number<L, K>& a, const Number<L, K>& b)
+	{
+		const typename L::Vector top = L::add(L::template shiftLeft<L::DigitBits>(L::sub(a.d[0], b.d[0])),
+											  L::sub(a.d[1], b.d[1]));
+		const typename L::Vector shifted = L::add(top, L::set1(1));
+		return L::andv(L::greater(L::set1(3), shifted), L::greater(shifted, L::set1(~(uint64)0)));
+	}
+
+	// Lanes where A is within 16 ulps of B, the cycle detection tolerance
+	template <class L, int K>
+	inline typename L::Vector near(const Number<L, K>& a, const Number<L, K>& b)
+	{
+		Number<L, K> difference;
+		sub(difference, a, b);
+		negateWhere(difference, difference, signMask(difference));
+
+		typename L::Vector high = L::zero();
+		for (int k = 0; k < K - 1; ++k)
+			high = L::orv(high, difference.d[k]);
+
+		return L::andv(L::equal(high, L::zero()), L::greater(L::set1(16), difference.d[K - 1]));
+	}
+
+	// Escape counts of the pixels (cx[i], cy) for i in [0, count).
+	// cx holds K digits per pixel, cy K digits. Orbits caught in a cycle
+	// are found as in escapeTime, the saved point of every lane moving
+	// on after 1, 2, 4, 8... iterations together.
+	template <class L, int K>
+	void iterateDigits(const uint64* cx, const uint64* cy, unsigned count, int resolution, int* counts)
+	{
+		const typename L::Vector one = L::set1(1);
+		const typename L::Vector ones = L::set1(~(uint64)0);
+		const typename L::Vector inside = L::set1((uint64)resolution);
+
+		Number<L, K> c_y;
+		for (int k = 0; k < K; ++k)
+			c_y.d[k] = L::set1(cy[k]);
+
+		for (unsigned first = 0; first < count; first += L::Count)
+		{
+			// Pad the last batch with copies of its first pixel
+			Number<L, K> c_x;
+			for (int k = 0; k < K; ++k)
+			{
+				uint64 digits[L::Count];
+				for (unsigned lane = 0; lane < (unsigned)L::Count; ++lane)
+				{
+					const unsigned i = (first + lane < count) ? first + lane : first;
+					digits[lane] = cx[i * K + k];
+				}
+				c_x.d[k] = L::load(digits);
+			}
+
+			Number<L, K> zx = c_x, zy = c_y;
+			Number<L, K> px = c_x, py = c_y;
+			Number<L, K> ax, ay, x2, y2, xy, norm;
+			int interval = 1;
+			int saveAt = 1;
+
+			// All ones while the lane has not escaped
+			typename L::Vector active = L::set1(~(uint64)0);
+			typename L::Vector iterations = L::zero();
+
+			for (int iteration = 0; iteration < resolution; ++iteration)
+			{
+				// Products on magnitudes, the sign of zx * zy put back after
+				const typename L::Vector signX = signMask(zx);
+				const typename L::Vector signY = signMask(zy);
+				negateWhere(ax, zx, signX);
+				negateWhere(ay, zy, signY);
+
+				square(x2, ax);
+				square(y2, ay);
+
+				add(norm, x2, y2);
+				active = L::andv(active, L::xorv(greaterThanFour(norm), L::set1(~(uint64)0)));
+				if (!L::any(active))
+					break;
+
+				iterations = L::add(iterations, L::andv(active, one));
+
+				multiply(xy, ax, ay);
+				add(xy, xy, xy);
+				negateWhere(xy, xy, L::xorv(signX, signY));
+				add(zy, xy, c_y);
+
+				sub(zx, x2, y2);
+				add(zx, zx, c_x);
+
+				// Lanes back on their saved point are inside the set
+				const typename L::Vector candidates = L::andv(active, L::andv(nearLeading(zx, px), nearLeading(zy, py)));
+				const typename L::Vector periodic = L::any(candidates)
+					? L::andv(candidates, L::andv(near(zx, px), near(zy, py))) : L::zero();
+				if (L::any(periodic))
+				{
+					iterations = L::orv(L::andv(periodic, inside), L::andv(L::xorv(periodic, ones), iterations));
+					active = L::andv(active, L::xorv(periodic, ones));
+					if (!L::any(active))
+						break;
+				}
+
+				if (iteration + 1 == saveAt)
+				{
+					px = zx;
+					py = zy;
+					interval *= 2;
+					saveAt += interval;
+				}
+			}
+
+			uint64 laneIterations[L::Count];
+			L::store(laneIterations, iterations);
+
+			for (unsigned lane = 0; lane < (unsigned)L::Count && first + lane < count; ++lane)
+				counts[first + lane] = (int)laneIterations[lane];
+		}
+	}
+
+	// iterateDigits for a number of digits known at run time, from 3 to
+	// 9: FPReal<2..5, uint64> on 32 or 52-bit digits
+	template <class L>
+	void iterateRow(const uint64* cx, const uint64* cy, unsigned count, int digits, int resolution, int* counts)
+	{
+		switch (digits)
+		{
+			case 3: iterateDigits<L, 3>(cx, cy, count, resolution, counts); break;
+			case 4: iterateDigits<L, 4>(cx, cy, count, resolution, counts); break;
+			case 5: iterateDigits<L, 5>(cx, cy, count, resolution, counts); break;
+			case 6: iterateDigits<L, 6>(cx, cy, count, resolution, counts); break;
+			case 7: iterateDigits<L, 7>(cx, cy, count, resolution, counts); break;
+			case 8: iterateDigits<L, 8>(cx, cy, count, resolution, counts); break;
+			case 9: iterateDigits<L, 9>(cx, cy, count, resolution, counts); break;
+		}
+	}
+
+	// Same kernel on plain integers, one pixel at a time: the fallback
+	// when a file could not be built with its instruction set
+	template <int D>
+	struct ScalarLanes
+	{
+		typedef uint64 Vector;
+		static const int DigitBits = D;
+		static const int Count = 1;
+
+		static Vector zero() { return 0; }
+		static Vector set1(uint64 x) { return x; }
+		static Vector load(const uint64* x) { return x[0]; }
+		static void store(uint64* x, Vector a) { x[0] = a; }
+		static Vector add(Vector a, Vector b) { return a + b; }
+		static Vector sub(Vector a, Vector b) { return a - b; }
+		static Vector andv(Vector a, Vector b) { return a & b; }
+		static Vector orv(Vector a, Vector b) { return a | b; }
+		static Vector xorv(Vector a, Vector b) { return a ^ b; }
+		template <int S> static Vector shiftLeft(Vector a) { return a << S; }
+		template <int S> static Vector shiftRight(Vector a) { return a >> S; }
+		static Vector equal(Vector a, Vector b) { return (a == b) ? ~(uint64)0 : 0; }
+		static Vector greater(Vector a, Vector b) { return ((long long)a > (long long)b) ? ~(uint64)0 : 0; }
+		static bool any(Vector a) { return a != 0; }
+
+		static void multiplyAdd(Vector& lo, Vector& hi, Vector a, Vector b)
+		{
+			uint64 h;
+			const uint64 l = mulLimb(a, b, &h);
+			lo += l & ((((uint64)1) << D) - 1);
+			hi += (l >> D) | (h << (64 - D));
+		}
+	};
+}
+
+#endif
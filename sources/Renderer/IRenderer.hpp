@@ -1,10 +1,104 @@
 #pragma once
 
 #include "../Real/mpfreal.hpp"
+#include <SFML/System/Time.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Number representations the automatic renderer picks from, cheapest first
+enum NumberRepresentation
+{
+	FloatRepresentation,
+	DoubleRepresentation,
+	DoubleDoubleRepresentation,
+	PerturbationRepresentation,
+	QuadDoubleRepresentation,
+	MultiPrecisionRepresentation,
+	RepresentationCount
+};
+
+// Per frame counters filled by the engines that support them
+struct RenderStatistics
+{
+	RenderStatistics() :
+	iterationsSkipped(0),
+	blaMemoryUsage(0),
+	blaBuildTime(sf::Time::Zero),
+	referenceCount(0),
+	glitchedPixels(0),
+	unresolvedGlitches(0),
+	rebases(0),
+	tileSize(0),
+	tileColumns(0),
+	tileRows(0),
+	tileRepresentations(),
+	tileEscalations(0),
+	arenaAllocations(0),
+	heapAllocations(0),
+	laneIterations(0),
+	activeLaneIterations(0),
+	floatLanes(false),
+	interiorPixels(0)
+	{
+		for (int i = 0; i < RepresentationCount; ++i)
+			tilesPerRepresentation[i] = 0;
+	}
+
+	// Iterations every pixel skipped thanks to series approximation
+	unsigned iterationsSkipped;
+
+	// Size and build time of the bilinear approximation table
+	size_t blaMemoryUsage;
+	sf::Time blaBuildTime;
+
+	// Perturbation reference orbits computed, pixels the first one
+	// could not render, and pixels none of them could
+	unsigned referenceCount;
+	unsigned glitchedPixels;
+	unsigned unresolvedGlitches;
+
+	// Times a pixel restarted from the beginning of the reference orbit
+	uint64_t rebases;
+
+	// Automatic mode: representation each tile ended up with, row by row
+	unsigned tileSize;
+	unsigned tileColumns;
+	unsigned tileRows;
+	std::vector<unsigned char> tileRepresentations;
+	unsigned tilesPerRepresentation[RepresentationCount];
+
+	// Tiles rendered again at a higher precision after losing it
+	unsigned tileEscalations;
+
+	// mpf limb allocations served by the thread arenas, mallocs avoided,
+	// and the ones that still went to the heap
+	uint64_t arenaAllocations;
+	uint64_t heapAllocations;
+
+	// SIMD engines: lane iterations run, and the ones that moved a pixel
+	// on; their ratio is the lane utilization
+	uint64_t laneIterations;
+	uint64_t activeLaneIterations;
+
+	// Double mode: the frame was shallow enough to iterate in float
+	bool floatLanes;
+
+	// Pixels the closed form test put in the main cardioid or the
+	// period-2 bulb, coloured without iterating
+	unsigned interiorPixels;
+};
 
 class IRenderer
 {
 public:
+	virtual ~IRenderer() {}
+
 	virtual void render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
 		mpfreal& zoom, int resolution, mpfreal& x, mpfreal& y) = 0;
-};
\ No newline at end of file
+
+	const RenderStatistics& getStatistics() const { return m_statistics; }
+
+protected:
+	RenderStatistics m_statistics;
+};
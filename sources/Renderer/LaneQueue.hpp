@@ -0,0 +1,361 @@
+/*
+ *  LaneQueue.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef LANE_QUEUE_HPP
+#define LANE_QUEUE_HPP
+
+#include <cstdint>
+#include <limits>
+
+// Escape time iteration of a row of pixels in float or double, on SIMD
+// lanes fed from a queue: when a lane escapes or reaches the resolution
+// its count is written out and the next pixel of the row takes the lane,
+// instead of the lane idling until the slowest pixel of its group is done.
+//
+// The escape test runs every checkInterval iterations only. Escaped
+// orbits keep growing (|z| > 2 >= |c|), so a lane beyond 2 at the check
+// escaped somewhere in the block: the block is then replayed from its
+// saved state, testing at each iteration, to the exact escape iteration
+// of the lanes that left. The other lanes simply move on from where the
+// replay stopped, every lane keeps its own count.
+//
+// Cycles are detected at the same checks, Brent's way: each lane keeps a
+// saved point that moves on to its z after 1, 2, 4, 8... blocks, and a
+// lane back exactly on it repeats forever, inside the set. No tolerance
+// here: near the cusp and the bulb roots escaping orbits crawl by
+// less than a few ulps per block. Checking every block instead of every
+// iteration only delays the detection until the interval is a multiple
+// of the period.
+//
+// The kernel is written once over a Lanes type providing, on a Vector of
+// Count Scalar (float or double):
+//   set1(Scalar), load(const Scalar*), store(Scalar*, Vector)
+//   add, sub, mul, fmadd(a, b, c) = a * b + c
+//   escaped(Vector norm): bit i set when lane i is not <= 4 (NaN included)
+//   equal(Vector a, Vector b): bit i set when a == b in lane i (NaN excluded)
+// Each file built with a wider instruction set defines its own Lanes and
+// runs Groups independent vectors of them, at most 32 lanes in all.
+
+namespace LaneQueue
+{
+	const int checkInterval = 8;
+
+	// Lane iterations run, replays included, and those that moved a pixel
+	// on: their ratio is the lane utilization
+	struct LaneUsage
+	{
+		LaneUsage() : iterations(0), active(0) {}
+
+		uint64_t iterations;
+		uint64_t active;
+	};
+
+	// z = z^2 + c, 2 * zx * zy + cy in one rounding
+	template <class L>
+	inline void step(typename L::Vector& zx, typename L::Vector& zy,
+					 typename L::Vector cx, typename L::Vector cy)
+	{
+		const typename L::Vector x2 = L::mul(zx, zx);
+		const typename L::Vector y2 = L::mul(zy, zy);
+
+		zy = L::fmadd(L::add(zx, zx), zy, cy);
+		zx = L::add(L::sub(x2, y2), cx);
+	}
+
+	// Lanes of the Groups vectors that are beyond 2, one bit each
+	template <class L, int Groups>
+	inline unsigned escapedLanes(const typename L::Vector zx[Groups], const typename L::Vector zy[Groups])
+	{
+		unsigned lanes = 0;
+		for (int g = 0; g < Groups; ++g)
+		{
+			const typename L::Vector norm = L::add(L::mul(zx[g], zx[g]), L::mul(zy[g], zy[g]));
+			lanes |= L::escaped(norm) << (g * L::Count);
+		}
+		return lanes;
+	}
+
+	// Lanes of the Groups vectors whose z is equal to p, one bit each
+	template <class L, int Groups>
+	inline unsigned periodicLanes(const typename L::Vector zx[Groups], const typename L::Vector zy[Groups],
+								  const typename L::Vector px[Groups], const typename L::Vector py[Groups])
+	{
+		unsigned lanes = 0;
+		for (int g = 0; g < Groups; ++g)
+		{
+			const unsigned x = L::equal(zx[g], px[g]);
+			const unsigned y = L::equal(zy[g], py[g]);
+			lanes |= (x & y) << (g * L::Count);
+		}
+		return lanes;
+	}
+
+	// Escape counts of the pixels (cx[i], cy) for i in [0, count)
+	template <class L, int Groups>
+	void iterateRow(const typename L::Scalar* cx, typename L::Scalar cy, unsigned count, int resolution, int* counts, LaneUsage& usage)
+	{
+		typedef typename L::Scalar Scalar;
+
+		const int lanes = Groups * L::Count;
+		const int64_t never = std::numeric_limits<int64_t>::max();
+		const Scalar unsaved = std::numeric_limits<Scalar>::quiet_NaN();
+
+		typename L::Vector zx[Groups], zy[Groups], c_x[Groups], c_y[Groups], px[Groups], py[Groups];
+
+		// Pixel of each lane, -1 once the queue is empty: the lane then
+		// holds c = 0, which never escapes. Counts are kept as the
+		// iteration of the row each lane started at, so that a block
+		// moves every lane on with a single addition. The saved points
+		// of the cycle detection start as NaN, which matches nothing.
+		int lanePixel[lanes];
+		int64_t laneStart[lanes];
+		int64_t laneSaveAt[lanes];
+		int64_t laneInterval[lanes];
+		Scalar laneX[lanes], laneY[lanes], laneZx[lanes], laneZy[lanes], lanePx[lanes], lanePy[lanes];
+
+		unsigned next = 0;
+		unsigned live = 0;
+		int64_t iteration = 0;
+		int64_t oldestStart = 0;
+		int64_t nextSave = never;
+
+		for (int lane = 0; lane < lanes; ++lane)
+		{
+			lanePixel[lane] = (next < count) ? (int)next++ : -1;
+			laneStart[lane] = 0;
+			laneInterval[lane] = checkInterval;
+			laneSaveAt[lane] = (lanePixel[lane] >= 0) ? checkInterval : never;
+			laneX[lane] = (lanePixel[lane] >= 0) ? cx[lanePixel[lane]] : 0;
+			laneY[lane] = (lanePixel[lane] >= 0) ? cy : 0;
+			lanePx[lane] = unsaved;
+			lanePy[lane] = unsaved;
+			live |= (lanePixel[lane] >= 0) ? 1u << lane : 0;
+			nextSave = (laneSaveAt[lane] < nextSave) ? laneSaveAt[lane] : nextSave;
+		}
+
+		for (int g = 0; g < Groups; ++g)
+		{
+			c_x[g] = L::load(laneX + g * L::Count);
+			c_y[g] = L::load(laneY + g * L::Count);
+			zx[g] = c_x[g];
+			zy[g] = c_y[g];
+			px[g] = L::load(lanePx + g * L::Count);
+			py[g] = L::load(lanePy + g * L::Count);
+		}
+
+		while (live != 0)
+		{
+			// Lanes done: escaped or caught in a cycle in the last block,
+			// or at the resolution. Only the oldest lanes can have
+			// reached it.
+			unsigned done = 0;
+
+			if (iteration - oldestStart == resolution)
+			{
+				for (int lane = 0; lane < lanes; ++lane)
+				{
+					if (lanePixel[lane] >= 0 && laneStart[lane] == oldestStart)
+					{
+						counts[lanePixel[lane]] = resolution;
+						usage.active += resolution;
+						done |= 1u << lane;
+					}
+				}
+			}
+			else
+			{
+				// Unchecked block, never past the resolution of any lane
+				const int remaining = int(resolution - (iteration - oldestStart));
+				const int length = (remaining < checkInterval) ? remaining : checkInterval;
+				typename L::Vector savedX[Groups], savedY[Groups];
+
+				for (int g = 0; g < Groups; ++g)
+				{
+					savedX[g] = zx[g];
+					savedY[g] = zy[g];
+				}
+
+				for (int i = 0; i < length; ++i)
+					for (int g = 0; g < Groups; ++g)
+						step<L>(zx[g], zy[g], c_x[g], c_y[g]);
+
+				usage.iterations += (uint64_t)lanes * length;
+
+				unsigned escaped = escapedLanes<L, Groups>(zx, zy);
+				int advanced = length;
+
+				if (escaped != 0)
+				{
+					// Replay the block, testing every iteration, until all
+					// the lanes that escaped in it are found
+					for (int g = 0; g < Groups; ++g)
+					{
+						zx[g] = savedX[g];
+						zy[g] = savedY[g];
+					}
+
+					advanced = 0;
+					for (;;)
+					{
+						const unsigned found = escapedLanes<L, Groups>(zx, zy) & escaped;
+
+						for (int lane = 0; lane < lanes; ++lane)
+						{
+							if (found & (1u << lane))
+							{
+								const int laneCount = int(iteration - laneStart[lane]) + advanced;
+								counts[lanePixel[lane]] = laneCount;
+								usage.active += laneCount;
+							}
+						}
+
+						done |= found;
+						escaped &= ~found;
+						if (escaped == 0)
+							break;
+
+						for (int g = 0; g < Groups; ++g)
+							step<L>(zx[g], zy[g], c_x[g], c_y[g]);
+
+						usage.iterations += lanes;
+						++advanced;
+					}
+				}
+
+				iteration += advanced;
+
+				// Lanes back on their saved point
+				const unsigned periodic = periodicLanes<L, Groups>(zx, zy, px, py) & live & ~done;
+
+				if (periodic != 0)
+				{
+					for (int lane = 0; lane < lanes; ++lane)
+					{
+						if (periodic & (1u << lane))
+						{
+							counts[lanePixel[lane]] = resolution;
+							usage.active += iteration - laneStart[lane];
+						}
+					}
+
+					done |= periodic;
+				}
+
+				// Saved points that move on to z
+				if (iteration >= nextSave)
+				{
+					for (int g = 0; g < Groups; ++g)
+					{
+						L::store(laneZx + g * L::Count, zx[g]);
+						L::store(laneZy + g * L::Count, zy[g]);
+						L::store(lanePx + g * L::Count, px[g]);
+						L::store(lanePy + g * L::Count, py[g]);
+					}
+
+					nextSave = never;
+					for (int lane = 0; lane < lanes; ++lane)
+					{
+						if (laneSaveAt[lane] <= iteration)
+						{
+							lanePx[lane] = laneZx[lane];
+							lanePy[lane] = laneZy[lane];
+							laneInterval[lane] *= 2;
+							laneSaveAt[lane] = iteration + laneInterval[lane];
+						}
+
+						nextSave = (laneSaveAt[lane] < nextSave) ? laneSaveAt[lane] : nextSave;
+					}
+
+					for (int g = 0; g < Groups; ++g)
+					{
+						px[g] = L::load(lanePx + g * L::Count);
+						py[g] = L::load(lanePy + g * L::Count);
+					}
+				}
+			}
+
+			if (done == 0)
+				continue;
+
+			// The next pixels of the queue take the lanes that are done
+			for (int g = 0; g < Groups; ++g)
+			{
+				L::store(laneZx + g * L::Count, zx[g]);
+				L::store(laneZy + g * L::Count, zy[g]);
+				L::store(laneX + g * L::Count, c_x[g]);
+				L::store(laneY + g * L::Count, c_y[g]);
+				L::store(lanePx + g * L::Count, px[g]);
+				L::store(lanePy + g * L::Count, py[g]);
+			}
+
+			oldestStart = iteration;
+			nextSave = never;
+			for (int lane = 0; lane < lanes; ++lane)
+			{
+				if (done & (1u << lane))
+				{
+					if (next < count)
+					{
+						lanePixel[lane] = (int)next++;
+						laneX[lane] = cx[lanePixel[lane]];
+						laneY[lane] = cy;
+						laneSaveAt[lane] = iteration + checkInterval;
+					}
+					else
+					{
+						lanePixel[lane] = -1;
+						laneX[lane] = 0;
+						laneY[lane] = 0;
+						laneSaveAt[lane] = never;
+						live &= ~(1u << lane);
+					}
+
+					laneStart[lane] = iteration;
+					laneInterval[lane] = checkInterval;
+					laneZx[lane] = laneX[lane];
+					laneZy[lane] = laneY[lane];
+					lanePx[lane] = unsaved;
+					lanePy[lane] = unsaved;
+				}
+				else if (lanePixel[lane] >= 0 && laneStart[lane] < oldestStart)
+					oldestStart = laneStart[lane];
+
+				nextSave = (laneSaveAt[lane] < nextSave) ? laneSaveAt[lane] : nextSave;
+			}
+
+			for (int g = 0; g < Groups; ++g)
+			{
+				zx[g] = L::load(laneZx + g * L::Count);
+				zy[g] = L::load(laneZy + g * L::Count);
+				c_x[g] = L::load(laneX + g * L::Count);
+				c_y[g] = L::load(laneY + g * L::Count);
+				px[g] = L::load(lanePx + g * L::Count);
+				py[g] = L::load(lanePy + g * L::Count);
+			}
+		}
+	}
+}
+
+#endif
@@ -31,6 +31,7 @@
 #ifdef OMP_BUILD
 
 #include "IRenderer.hpp"
+#include "CoordinateGenerator.hpp"
 #include <SFML/System/Vector2.hpp>
 #include <mpir/gmp.h>
 
@@ -39,6 +40,13 @@ public:
 	
 	virtual void render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
 					   mpfreal& zoom, int resolution, mpfreal& x, mpfreal& y);
+
+private:
+	// Real: mpfreal, or mpfreal_fixed when the precision fits
+	template <typename Real>
+	void _render(unsigned char *pixelBuffer, unsigned width, unsigned heigth, int resolution);
+
+	CoordinateGenerator m_coordinates;
 };
 
 #endif
@@ -0,0 +1,515 @@
+/*
+ *  MandelbrotRendererAuto.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "../Common.hpp"
+
+#ifdef OMP_BUILD
+
+#include "MandelbrotRendererAuto.hpp"
+#include "MandelbrotRendererDouble.hpp"
+#include "MandelbrotRendererDoubleDouble.hpp"
+#include "MandelbrotRendererQuadDouble.hpp"
+#include "EscapeTime.hpp"
+#include "../Real/mpfarena.hpp"
+#include "../Real/mpfreal_fixed.hpp"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+	const unsigned tileSize = 64;
+
+	// Bits kept beyond those needed to tell neighbouring pixels apart,
+	// for the rounding errors the iterations pile up
+	const double guardBits = 8;
+
+	// Mantissa bits of the representations iterated directly per pixel
+	const double floatBits = 24;
+	const double doubleBits = 53;
+	const double doubleDoubleBits = 106;
+	const double quadDoubleBits = 212;
+}
+
+MandelbrotRendererAuto::MandelbrotRendererAuto(const PerturbationSettings& settings) :
+m_pixelBuffer(NULL),
+m_width(0),
+m_heigth(0),
+m_resolution(0),
+m_coordinates(),
+m_columnsf(),
+m_rowsf(),
+m_columnsd(),
+m_rowsd(),
+m_columnsdd(),
+m_rowsdd(),
+m_columnsqd(),
+m_rowsqd(),
+m_interior(),
+m_tiles(),
+m_perturbation(settings)
+{
+}
+
+void MandelbrotRendererAuto::render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
+	mpfreal& zoom, int resolution, mpfreal& x, mpfreal& y)
+{
+	const mpfarena::Statistics arenaBefore = mpfarena::getStatistics();
+
+	m_coordinates.compute(width, heigth, zoom, x, y);
+
+	m_pixelBuffer = pixelBuffer;
+	m_width = width;
+	m_heigth = heigth;
+	m_resolution = resolution;
+	m_coordinates.getColumns(m_columnsf);
+	m_coordinates.getRows(m_rowsf);
+	m_coordinates.getColumns(m_columnsd);
+	m_coordinates.getRows(m_rowsd);
+	m_coordinates.getColumns(m_columnsdd);
+	m_coordinates.getRows(m_rowsdd);
+	m_coordinates.getColumns(m_columnsqd);
+	m_coordinates.getRows(m_rowsqd);
+
+	// Pixels the interior test settles, once for the frame: the tiles,
+	// their probes and the later passes leave them alone
+	long long interior = 0;
+	m_interior.assign(width * heigth, 0);
+
+	#pragma omp parallel for schedule(dynamic) reduction(+:interior)
+	for (int image_y = 0; image_y < (int)heigth; ++image_y)
+	{
+		for (unsigned image_x = 0; image_x < width; ++image_x)
+		{
+			if (!isInMainComponents(m_columnsd[image_x], m_rowsd[image_y]))
+				continue;
+
+			unsigned char* pixel = m_pixelBuffer + (image_y * width + image_x) * 4;
+
+			pixel[0] = _color(resolution);
+			pixel[1] = 0;
+			pixel[2] = 0;
+			pixel[3] = 255;
+
+			m_interior[image_y * width + image_x] = 1;
+			++interior;
+		}
+	}
+
+	const unsigned columns = (width + tileSize - 1) / tileSize;
+	const unsigned rows = (heigth + tileSize - 1) / tileSize;
+
+	m_tiles.clear();
+	for (unsigned row = 0; row < rows; ++row)
+	{
+		for (unsigned column = 0; column < columns; ++column)
+		{
+			Tile tile;
+			tile.left = column * tileSize;
+			tile.top = row * tileSize;
+			tile.right = std::min(tile.left + tileSize, width);
+			tile.bottom = std::min(tile.top + tileSize, heigth);
+			tile.bits = _requiredBits(tile);
+			tile.representation = _cheapestRepresentation(tile);
+			m_tiles.push_back(tile);
+		}
+	}
+
+	// Tiles iterated directly, escalating until their probes agree or
+	// they need perturbation. The lane usage of the float and double
+	// tiles goes in the statistics at the end, escalated renders included.
+	int escalations = 0;
+	long long laneIterations = 0;
+	long long activeLaneIterations = 0;
+
+	#pragma omp parallel for schedule(dynamic) reduction(+:escalations, laneIterations, activeLaneIterations)
+	for (int i = 0; i < (int)m_tiles.size(); ++i)
+	{
+		Tile& tile = m_tiles[i];
+
+		while (tile.representation < PerturbationRepresentation)
+		{
+			const LaneQueue::LaneUsage usage = _renderTile(tile);
+			laneIterations += usage.iterations;
+			activeLaneIterations += usage.active;
+
+			if (!_hasLostPrecision(tile))
+				break;
+
+			tile.representation = NumberRepresentation(tile.representation + 1);
+			++escalations;
+		}
+	}
+
+	m_statistics = RenderStatistics();
+
+	// One perturbation pass shared by all the deep tiles
+	std::vector<unsigned> pixels;
+	for (size_t i = 0; i < m_tiles.size(); ++i)
+	{
+		const Tile& tile = m_tiles[i];
+		if (tile.representation != PerturbationRepresentation)
+			continue;
+
+		for (unsigned image_y = tile.top; image_y < tile.bottom; ++image_y)
+			for (unsigned image_x = tile.left; image_x < tile.right; ++image_x)
+				if (!m_interior[image_y * width + image_x])
+					pixels.push_back(image_y * width + image_x);
+	}
+
+	if (!pixels.empty())
+	{
+		m_perturbation.renderPixels(pixelBuffer, m_coordinates, resolution, pixels);
+		m_statistics = m_perturbation.getStatistics();
+
+		const std::vector<unsigned>& glitches = m_perturbation.getUnresolvedGlitches();
+		for (size_t i = 0; i < glitches.size(); ++i)
+		{
+			Tile& tile = m_tiles[(glitches[i] / width) / tileSize * columns + (glitches[i] % width) / tileSize];
+
+			if (tile.representation == PerturbationRepresentation)
+			{
+				tile.representation = (tile.bits <= quadDoubleBits) ? QuadDoubleRepresentation : MultiPrecisionRepresentation;
+				++escalations;
+			}
+		}
+	}
+
+	// Quad-double tiles, checked against mpf like the direct ones
+	#pragma omp parallel for schedule(dynamic) reduction(+:escalations)
+	for (int i = 0; i < (int)m_tiles.size(); ++i)
+	{
+		Tile& tile = m_tiles[i];
+		if (tile.representation != QuadDoubleRepresentation)
+			continue;
+
+		_renderTile(tile);
+
+		if (_hasLostPrecision(tile))
+		{
+			tile.representation = MultiPrecisionRepresentation;
+			++escalations;
+		}
+	}
+
+	// Whatever is left goes through mpf
+	pixels.clear();
+	for (size_t i = 0; i < m_tiles.size(); ++i)
+	{
+		const Tile& tile = m_tiles[i];
+		if (tile.representation != MultiPrecisionRepresentation)
+			continue;
+
+		for (unsigned image_y = tile.top; image_y < tile.bottom; ++image_y)
+			for (unsigned image_x = tile.left; image_x < tile.right; ++image_x)
+				if (!m_interior[image_y * width + image_x])
+					pixels.push_back(image_y * width + image_x);
+	}
+
+	#pragma omp parallel for schedule(dynamic, 64)
+	for (int i = 0; i < (int)pixels.size(); ++i)
+	{
+		const int count = _iterateMultiPrecision(pixels[i] % width, pixels[i] / width);
+		unsigned char* pixel = m_pixelBuffer + pixels[i] * 4;
+
+		pixel[0] = _color(count);
+		pixel[1] = 0;
+		pixel[2] = 0;
+		pixel[3] = 255;
+	}
+
+	const mpfarena::Statistics arenaAfter = mpfarena::getStatistics();
+	m_statistics.arenaAllocations = arenaAfter.arenaAllocations - arenaBefore.arenaAllocations;
+	m_statistics.heapAllocations = arenaAfter.heapAllocations - arenaBefore.heapAllocations;
+
+	m_statistics.laneIterations = laneIterations;
+	m_statistics.activeLaneIterations = activeLaneIterations;
+	m_statistics.interiorPixels = (unsigned)interior;
+	m_statistics.tileSize = tileSize;
+	m_statistics.tileColumns = columns;
+	m_statistics.tileRows = rows;
+	m_statistics.tileEscalations = escalations;
+	m_statistics.tileRepresentations.resize(m_tiles.size());
+
+	for (size_t i = 0; i < m_tiles.size(); ++i)
+	{
+		m_statistics.tileRepresentations[i] = (unsigned char)m_tiles[i].representation;
+		++m_statistics.tilesPerRepresentation[m_tiles[i].representation];
+	}
+}
+
+const char* MandelbrotRendererAuto::getRepresentationName(NumberRepresentation representation)
+{
+	switch (representation) {
+		case FloatRepresentation:			return "float";
+		case DoubleRepresentation:			return "double";
+		case DoubleDoubleRepresentation:	return "double-double";
+		case PerturbationRepresentation:	return "perturbation";
+		case QuadDoubleRepresentation:		return "quad-double";
+		case MultiPrecisionRepresentation:	return "mpf";
+		default:							return "unknown";
+	}
+}
+
+double MandelbrotRendererAuto::_requiredBits(const Tile& tile) const
+{
+	// Largest coordinate of the tile, its corners bound it
+	double magnitude = 0;
+	const unsigned xs[2] = { tile.left, tile.right - 1 };
+	const unsigned ys[2] = { tile.top, tile.bottom - 1 };
+
+	for (int i = 0; i < 2; ++i)
+	{
+		magnitude = std::max(magnitude, std::fabs(m_columnsd[xs[i]]));
+		magnitude = std::max(magnitude, std::fabs(m_rowsd[ys[i]]));
+	}
+
+	// The step underflows double on deep zooms, its exponent does not
+	signed long int stepExponent;
+	const double stepMantissa = mpf_get_d_2exp(&stepExponent, *m_coordinates.getStep());
+	const double stepLog2 = std::log(stepMantissa) / std::log(2.0) + stepExponent;
+	const double magnitudeLog2 = std::log(std::max(magnitude, 1.0 / (1 << 20))) / std::log(2.0);
+
+	return magnitudeLog2 - stepLog2 + guardBits;
+}
+
+NumberRepresentation MandelbrotRendererAuto::_cheapestRepresentation(const Tile& tile) const
+{
+	const double bits = tile.bits;
+
+	if (bits <= floatBits)
+		return FloatRepresentation;
+	if (bits <= doubleBits)
+		return DoubleRepresentation;
+	if (bits <= doubleDoubleBits)
+		return DoubleDoubleRepresentation;
+	return PerturbationRepresentation;
+}
+
+LaneQueue::LaneUsage MandelbrotRendererAuto::_renderTile(const Tile& tile)
+{
+	switch (tile.representation) {
+		case FloatRepresentation:			return _renderTileLanes(tile, m_columnsf, m_rowsf);
+		case DoubleRepresentation:			return _renderTileLanes(tile, m_columnsd, m_rowsd);
+		case DoubleDoubleRepresentation:	_renderTileDoubleDouble(tile);		break;
+		case QuadDoubleRepresentation:		_renderTileQuadDouble(tile);		break;
+		default:							break;
+	}
+
+	return LaneQueue::LaneUsage();
+}
+
+bool MandelbrotRendererAuto::_hasLostPrecision(const Tile& tile) const
+{
+	// Perturbation has no per pixel entry point, mpf stands in for it
+	NumberRepresentation next = NumberRepresentation(tile.representation + 1);
+	if (next == PerturbationRepresentation)
+		next = MultiPrecisionRepresentation;
+
+	// Probes on a regular grid: 4x4 when the next representation is
+	// iterated directly, 2x2 when it is mpf
+	const int probes = (next == MultiPrecisionRepresentation) ? 2 : 4;
+	const unsigned width = tile.right - tile.left;
+	const unsigned heigth = tile.bottom - tile.top;
+
+	for (int i = 0; i < probes; ++i)
+	{
+		for (int j = 0; j < probes; ++j)
+		{
+			const int image_x = tile.left + width * (1 + 2 * i) / (2 * probes);
+			const int image_y = tile.top + heigth * (1 + 2 * j) / (2 * probes);
+			const unsigned char rendered = m_pixelBuffer[(image_y * m_width + image_x) * 4];
+
+			// Only differences that show count
+			if (_color(_iteratePixel(next, image_x, image_y)) != rendered)
+				return true;
+		}
+	}
+
+	return false;
+}
+
+int MandelbrotRendererAuto::_iteratePixel(NumberRepresentation representation, int image_x, int image_y) const
+{
+	if (m_interior[image_y * m_width + image_x])
+		return m_resolution;
+
+	switch (representation) {
+		case FloatRepresentation:
+			return _iterate<float>(m_columnsf[image_x], m_rowsf[image_y]);
+		case DoubleRepresentation:
+			return _iterate<double>(m_columnsd[image_x], m_rowsd[image_y]);
+		case DoubleDoubleRepresentation:
+			return _iterateDoubleDouble(image_x, image_y);
+		case QuadDoubleRepresentation:
+			return _iterateQuadDouble(image_x, image_y);
+		default:
+			return _iterateMultiPrecision(image_x, image_y);
+	}
+}
+
+template <typename T>
+int MandelbrotRendererAuto::_iterate(T cx, T cy) const
+{
+	return escapeTime<EscapeTimeTraits<T> >(cx, cy, m_resolution);
+}
+
+int MandelbrotRendererAuto::_iterateMultiPrecision(int image_x, int image_y) const
+{
+	// Temporaries with inline limbs when the precision allows it
+	if (mpfreal_fixed<256>::fits())
+		return _iterateMultiPrecision<mpfreal_fixed<256> >(image_x, image_y);
+	if (mpfreal_fixed<512>::fits())
+		return _iterateMultiPrecision<mpfreal_fixed<512> >(image_x, image_y);
+	if (mpfreal_fixed<1024>::fits())
+		return _iterateMultiPrecision<mpfreal_fixed<1024> >(image_x, image_y);
+	return _iterateMultiPrecision<mpfreal>(image_x, image_y);
+}
+
+template <typename Real>
+int MandelbrotRendererAuto::_iterateMultiPrecision(int image_x, int image_y) const
+{
+	mpfarena::Scope arena;
+
+	return escapeTime<EscapeTimeTraits<Real, mpfreal> >(m_coordinates.getX(image_x), m_coordinates.getY(image_y), m_resolution);
+}
+
+void MandelbrotRendererAuto::_outsideColumns(unsigned image_y, unsigned left, unsigned right,
+	std::vector<unsigned>& columns) const
+{
+	columns.clear();
+	for (unsigned image_x = left; image_x < right; ++image_x)
+	{
+		if (!m_interior[image_y * m_width + image_x])
+			columns.push_back(image_x);
+	}
+}
+
+template <typename T>
+LaneQueue::LaneUsage MandelbrotRendererAuto::_renderTileLanes(const Tile& tile, const std::vector<T>& columns, const std::vector<T>& rows)
+{
+	std::vector<unsigned> outside;
+	std::vector<T> cx;
+	std::vector<int> counts;
+	LaneQueue::LaneUsage usage;
+
+	for (unsigned image_y = tile.top; image_y < tile.bottom; ++image_y)
+	{
+		_outsideColumns(image_y, tile.left, tile.right, outside);
+		if (outside.empty())
+			continue;
+
+		cx.resize(outside.size());
+		counts.resize(outside.size());
+		for (size_t i = 0; i < outside.size(); ++i)
+			cx[i] = columns[outside[i]];
+
+		MandelbrotRendererDouble::iterate(&cx[0], rows[image_y], (unsigned)outside.size(), m_resolution, &counts[0], usage);
+
+		for (size_t i = 0; i < outside.size(); ++i)
+		{
+			unsigned char* pixel = m_pixelBuffer + (image_y * m_width + outside[i]) * 4;
+
+			pixel[0] = _color(counts[i]);
+			pixel[1] = 0;
+			pixel[2] = 0;
+			pixel[3] = 255;
+		}
+	}
+
+	return usage;
+}
+
+void MandelbrotRendererAuto::_renderTileDoubleDouble(const Tile& tile)
+{
+	std::vector<unsigned> outside;
+	std::vector<doubledouble> cx;
+	std::vector<doubledouble> cy;
+	std::vector<int> counts;
+
+	for (unsigned image_y = tile.top; image_y < tile.bottom; ++image_y)
+	{
+		_outsideColumns(image_y, tile.left, tile.right, outside);
+		if (outside.empty())
+			continue;
+
+		cx.resize(outside.size());
+		cy.assign(outside.size(), m_rowsdd[image_y]);
+		counts.resize(outside.size());
+		for (size_t i = 0; i < outside.size(); ++i)
+			cx[i] = m_columnsdd[outside[i]];
+
+		MandelbrotRendererDoubleDouble::iterate(&cx[0], &cy[0], (unsigned)outside.size(), m_resolution, &counts[0]);
+
+		for (size_t i = 0; i < outside.size(); ++i)
+		{
+			unsigned char* pixel = m_pixelBuffer + (image_y * m_width + outside[i]) * 4;
+
+			pixel[0] = _color(counts[i]);
+			pixel[1] = 0;
+			pixel[2] = 0;
+			pixel[3] = 255;
+		}
+	}
+}
+
+int MandelbrotRendererAuto::_iterateDoubleDouble(int image_x, int image_y) const
+{
+	int count;
+	MandelbrotRendererDoubleDouble::iterate(&m_columnsdd[image_x], &m_rowsdd[image_y], 1, m_resolution, &count);
+	return count;
+}
+
+void MandelbrotRendererAuto::_renderTileQuadDouble(const Tile& tile)
+{
+	for (unsigned image_y = tile.top; image_y < tile.bottom; ++image_y)
+	{
+		for (unsigned image_x = tile.left; image_x < tile.right; ++image_x)
+		{
+			if (m_interior[image_y * m_width + image_x])
+				continue;
+
+			unsigned char* pixel = m_pixelBuffer + (image_y * m_width + image_x) * 4;
+
+			pixel[0] = _color(_iterateQuadDouble(image_x, image_y));
+			pixel[1] = 0;
+			pixel[2] = 0;
+			pixel[3] = 255;
+		}
+	}
+}
+
+int MandelbrotRendererAuto::_iterateQuadDouble(int image_x, int image_y) const
+{
+	return MandelbrotRendererQuadDouble::iterate(m_columnsqd[image_x], m_rowsqd[image_y], m_resolution);
+}
+
+unsigned char MandelbrotRendererAuto::_color(int count) const
+{
+	if (count == m_resolution)
+		return 0;
+
+	return (unsigned char)(count * 255 / m_resolution);
+}
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ *  MandelbrotRendererAuto.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef MANDELBROT_RENDERER_AUTO_HPP
+#define MANDELBROT_RENDERER_AUTO_HPP
+
+#ifdef OMP_BUILD
+
+#include "IRenderer.hpp"
+#include "MandelbrotRendererPerturbation.hpp"
+#include "CoordinateGenerator.hpp"
+#include "LaneQueue.hpp"
+#include "../Real/doubledouble.hpp"
+#include "../Real/quaddouble.hpp"
+#include <vector>
+
+// Splits the frame in tiles and renders each of them with the cheapest
+// number representation that can still tell its pixels apart, given the
+// pixel spacing and the magnitude of the coordinates in the tile.
+// A few probe pixels of every tile are iterated again one representation
+// higher: when they disagree the tile has lost precision and is rendered
+// again with that representation. Tiles perturbation leaves glitched go
+// through quad-double when its 212 bits are enough, mpf otherwise.
+class MandelbrotRendererAuto : public IRenderer {
+public:
+	MandelbrotRendererAuto(const PerturbationSettings& settings = PerturbationSettings());
+
+	virtual void render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
+					   mpfreal& zoom, int resolution, mpfreal& x, mpfreal& y);
+
+	static const char* getRepresentationName(NumberRepresentation representation);
+
+private:
+	struct Tile
+	{
+		unsigned left, top;
+		unsigned right, bottom; // excluded
+		double bits; // mantissa bits needed
+		NumberRepresentation representation;
+	};
+
+	double _requiredBits(const Tile& tile) const;
+	NumberRepresentation _cheapestRepresentation(const Tile& tile) const;
+
+	// Render the tile with its current representation and tell whether
+	// its probes disagree with the next one. Float and double tiles
+	// return the usage of their lanes.
+	LaneQueue::LaneUsage _renderTile(const Tile& tile);
+	bool _hasLostPrecision(const Tile& tile) const;
+
+	// Escape count of one pixel with the given representation
+	int _iteratePixel(NumberRepresentation representation, int image_x, int image_y) const;
+
+	template <typename T>
+	int _iterate(T cx, T cy) const;
+
+	int _iterateMultiPrecision(int image_x, int image_y) const;
+
+	// Real: mpfreal, or mpfreal_fixed when the precision fits
+	template <typename Real>
+	int _iterateMultiPrecision(int image_x, int image_y) const;
+
+	// Columns of the row segment [left, right) the interior test did not settle
+	void _outsideColumns(unsigned image_y, unsigned left, unsigned right, std::vector<unsigned>& columns) const;
+
+	// T: float or double, iterated by the SIMD kernels of the double engine
+	template <typename T>
+	LaneQueue::LaneUsage _renderTileLanes(const Tile& tile, const std::vector<T>& columns, const std::vector<T>& rows);
+
+	void _renderTileDoubleDouble(const Tile& tile);
+	int _iterateDoubleDouble(int image_x, int image_y) const;
+
+	void _renderTileQuadDouble(const Tile& tile);
+	int _iterateQuadDouble(int image_x, int image_y) const;
+
+	unsigned char _color(int count) const;
+
+	unsigned char* m_pixelBuffer;
+	unsigned m_width;
+	unsigned m_heigth;
+	int m_resolution;
+
+	// Column and row coordinates, in every representation
+	CoordinateGenerator m_coordinates;
+	std::vector<float> m_columnsf;
+	std::vector<float> m_rowsf;
+	std::vector<double> m_columnsd;
+	std::vector<double> m_rowsd;
+	std::vector<doubledouble> m_columnsdd;
+	std::vector<doubledouble> m_rowsdd;
+	std::vector<quaddouble> m_columnsqd;
+	std::vector<quaddouble> m_rowsqd;
+
+	// Pixels inside the main cardioid or the period-2 bulb
+	std::vector<unsigned char> m_interior;
+
+	std::vector<Tile> m_tiles;
+	MandelbrotRendererPerturbation m_perturbation;
+};
+
+#endif
+
+#endif
@@ -32,6 +32,7 @@
 #include <iostream>
 #include <SFML/System.hpp>
 #include "../Real/FPReal.hpp"
+#include "EscapeTime.hpp"
 
 GPU_ADD_STATIC_CODE(
 	"#pragma OPENCL EXTENSION cl_khr_fp64 : enable\n"
@@ -171,6 +172,38 @@ uint4 sqrfp(uint4 u)
 	// Product is positive
 	return sqrfpu(uu);
 }
+
+// Return U as a double, to within a few ulps
+double todouble128(uint4 u)
+{
+	uint su = u.x & 0x80000000U;
+	uint4 uu = (su)?neg128(u):u;
+	double d = (double)uu.x + ldexp((double)uu.y,-32) + ldexp((double)uu.z,-64);
+	return (su)?-d:d;
+}
+
+// Same closed form interior test as isInMainComponents on the host:
+// the main cardioid or the period-2 bulb, by a margin
+int inMainComponents(double2 c)
+{
+	const double margin = 1e-11;
+	if (c.x < -1.25 || c.x > 0.375 || c.y < -0.65 || c.y > 0.65)
+		return 0;
+	if (c.x < -0.75)
+		return sqrt((c.x+1.0)*(c.x+1.0) + c.y*c.y) < 0.25 - margin;
+	double ax = c.x - 0.25;
+	double p = sqrt(ax*ax + c.y*c.y);
+	return p - 2.0*p*p - ax > margin;
+}
+
+// U within 16 ulps of V, the cycle detection tolerance of fp128
+int near128(uint4 u, uint4 v)
+{
+	uint4 d = add128(u, neg128(v));
+	if ((int)d.x < 0)
+		d = neg128(d);
+	return d.x == 0 && d.y == 0 && d.z == 0 && d.w < 16;
+}
 );
 
 GPU_FILLKERNEL_2D(unsigned int,
@@ -185,7 +218,18 @@ double2 c=(double2)(
 	);
 double2 z=c;
 
-int count;
+// Brent's cycle detection: z is compared with p, which moves on to z
+// after 1, 2, 4, 8... iterations; an orbit back exactly on it is inside
+// the set
+double2 p=c;
+int interval=1;
+int steps=0;
+
+// resolution + 1 tells the host the interior test settled the pixel
+int count=0;
+if (inMainComponents(c))
+	count=resolution+1;
+else
 for (count=0;count<resolution;count++)
 {
 	double x2 = z.x*z.x;
@@ -196,6 +240,17 @@ for (count=0;count<resolution;count++)
 		x2-y2 + c.x,
 		2.0f*z.x*z.y + c.y
 		);
+	if (z.x == p.x && z.y == p.y)
+	{
+		count=resolution;
+		break;
+	}
+	if (++steps == interval)
+	{
+		p=z;
+		steps=0;
+		interval*=2;
+	}
 }
 
 result=count;
@@ -235,7 +290,15 @@ GPU_FILLKERNEL_2D(unsigned int,
 	uint4 zx = cx;
 	uint4 zy = cy;
 
-int count;
+	uint4 px = cx;
+	uint4 py = cy;
+	int interval = 1;
+	int steps = 0;
+
+int count=0;
+if (inMainComponents((double2)(todouble128(cx), todouble128(cy))))
+	count=resolution+1;
+else
 for (count=0;count<resolution;count++)
 {
 	uint4 x2 = sqrfp(zx);
@@ -246,6 +309,18 @@ for (count=0;count<resolution;count++)
 	uint4 twoxy = shl128(mulfp(zx,zy));
 	zx = add128(cx, add128(x2, neg128(y2)));
 	zy = add128(cy, twoxy);
+	if (near128(zx, px) && near128(zy, py))
+	{
+		count=resolution;
+		break;
+	}
+	if (++steps == interval)
+	{
+		px = zx;
+		py = zy;
+		steps = 0;
+		interval *= 2;
+	}
 }
 
 result=count;
@@ -289,24 +364,20 @@ void MandelbrotRendererCL::render(unsigned char *pixelBuffer, unsigned width, un
 
 	unsigned int* ca = new unsigned int[width*heigth];
 	img.read(ca);
+
+	// The kernels answer resolution + 1 for the pixels the interior test
+	// settled, they are inside the set all the same
+	m_statistics = RenderStatistics();
 	for(unsigned x = 0; x < width;++x)
 		for(unsigned y = 0; y < heigth;++y)
 		{
-			if (ca[y * width + x] == resolution)
-			{
-				pixelBuffer[(y * width + x) * 4 + 0] = 0;
-				pixelBuffer[(y * width + x) * 4 + 1] = 0;
-				pixelBuffer[(y * width + x) * 4 + 2] = 0;
-				pixelBuffer[(y * width + x) * 4 + 3] = 255;
-			}
-			else
+			int count = ca[y * width + x];
+			if (count > resolution)
 			{
-				int val = ca[y * width + x] * 255 / resolution;
-				pixelBuffer[(y * width + x) * 4 + 0] = val;
-				pixelBuffer[(y * width + x) * 4 + 1] = 0;
-				pixelBuffer[(y * width + x) * 4 + 2] = 0;
-				pixelBuffer[(y * width + x) * 4 + 3] = 255;
+				count = resolution;
+				++m_statistics.interiorPixels;
 			}
+			setEscapeColor(pixelBuffer + (y * width + x) * 4, count, resolution);
 		}
 
 	delete[] ca;
@@ -0,0 +1,164 @@
+/*
+ *  MandelbrotRendererDouble.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "../Common.hpp"
+
+#ifdef OMP_BUILD
+
+#include "MandelbrotRendererDouble.hpp"
+#include "EscapeTime.hpp"
+#include "../CpuFeatures.hpp"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	// Same rule as the automatic mode: bits to tell neighbouring pixels
+	// apart, plus guard bits for the rounding errors of the iterations,
+	// against the 24 bits of the float mantissa
+	const double guardBits = 8;
+	const double floatBits = 24;
+}
+
+void MandelbrotRendererDouble::render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
+	mpfreal& zoom, int resolution, mpfreal& x, mpfreal& y)
+{
+	m_coordinates.compute(width, heigth, zoom, x, y);
+
+	m_statistics = RenderStatistics();
+	m_statistics.floatLanes = _fitsFloat();
+
+	if (m_statistics.floatLanes)
+		_render<float>(pixelBuffer, width, heigth, resolution);
+	else
+		_render<double>(pixelBuffer, width, heigth, resolution);
+}
+
+bool MandelbrotRendererDouble::_fitsFloat() const
+{
+	// Largest coordinate of the frame, its corners bound it
+	const unsigned width = m_coordinates.getWidth();
+	const unsigned heigth = m_coordinates.getHeigth();
+	double magnitude = 0;
+
+	magnitude = std::max(magnitude, std::fabs(m_coordinates.getX(0).get<double>()));
+	magnitude = std::max(magnitude, std::fabs(m_coordinates.getX(width - 1).get<double>()));
+	magnitude = std::max(magnitude, std::fabs(m_coordinates.getY(0).get<double>()));
+	magnitude = std::max(magnitude, std::fabs(m_coordinates.getY(heigth - 1).get<double>()));
+
+	signed long int stepExponent;
+	const double stepMantissa = mpf_get_d_2exp(&stepExponent, *m_coordinates.getStep());
+	const double stepLog2 = std::log(stepMantissa) / std::log(2.0) + stepExponent;
+	const double magnitudeLog2 = std::log(std::max(magnitude, 1.0 / (1 << 20))) / std::log(2.0);
+
+	return magnitudeLog2 - stepLog2 + guardBits <= floatBits;
+}
+
+template <typename T>
+void MandelbrotRendererDouble::_render(unsigned char *pixelBuffer, unsigned width, unsigned heigth, int resolution)
+{
+	// Column and row coordinates, the only mpf work of the frame
+	std::vector<T> columns;
+	std::vector<T> rows;
+
+	m_coordinates.getColumns(columns);
+	m_coordinates.getRows(rows);
+
+	// Lane iterations and interior pixels summed over the rows, in the
+	// statistics at the end
+	long long laneIterations = 0;
+	long long activeLaneIterations = 0;
+	long long interior = 0;
+
+	#pragma omp parallel for schedule(dynamic) reduction(+:laneIterations, activeLaneIterations, interior)
+	for (int image_y = 0; image_y < (int)heigth; ++image_y)
+	{
+		std::vector<int> counts(width);
+		std::vector<unsigned> outside;
+		LaneQueue::LaneUsage usage;
+
+		interior += findInterior<EscapeTimeTraits<T> >(&columns[0], rows[image_y], width, resolution, &counts[0], outside);
+
+		// The lanes only see the pixels left to iterate
+		const unsigned count = (unsigned)outside.size();
+		std::vector<T> cx(count);
+		std::vector<int> outsideCounts(count);
+
+		for (unsigned i = 0; i < count; ++i)
+			cx[i] = columns[outside[i]];
+
+		if (count > 0)
+			iterate(&cx[0], rows[image_y], count, resolution, &outsideCounts[0], usage);
+
+		for (unsigned i = 0; i < count; ++i)
+			counts[outside[i]] = outsideCounts[i];
+
+		for (unsigned image_x = 0; image_x < width; ++image_x)
+			setEscapeColor(pixelBuffer + (image_y * width + image_x) * 4, counts[image_x], resolution);
+
+		laneIterations += usage.iterations;
+		activeLaneIterations += usage.active;
+	}
+
+	m_statistics.laneIterations = laneIterations;
+	m_statistics.activeLaneIterations = activeLaneIterations;
+	m_statistics.interiorPixels = (unsigned)interior;
+}
+
+void MandelbrotRendererDouble::iterate(const double* cx, double cy, unsigned count, int resolution, int* counts,
+	LaneQueue::LaneUsage& usage)
+{
+	if (CpuFeatures::hasAVX512())
+		_iterateAVX512(cx, cy, count, resolution, counts, usage);
+	else if (CpuFeatures::hasAVX2())
+		_iterateAVX2(cx, cy, count, resolution, counts, usage);
+	else
+		_iterateScalar(cx, cy, count, resolution, counts);
+}
+
+void MandelbrotRendererDouble::iterate(const float* cx, float cy, unsigned count, int resolution, int* counts,
+	LaneQueue::LaneUsage& usage)
+{
+	if (CpuFeatures::hasAVX512())
+		_iterateAVX512(cx, cy, count, resolution, counts, usage);
+	else if (CpuFeatures::hasAVX2())
+		_iterateAVX2(cx, cy, count, resolution, counts, usage);
+	else
+		_iterateScalar(cx, cy, count, resolution, counts);
+}
+
+void MandelbrotRendererDouble::_iterateScalar(const double* cx, double cy, unsigned count, int resolution, int* counts)
+{
+	for (unsigned i = 0; i < count; ++i)
+		counts[i] = escapeTime<EscapeTimeTraits<double> >(cx[i], cy, resolution);
+}
+
+void MandelbrotRendererDouble::_iterateScalar(const float* cx, float cy, unsigned count, int resolution, int* counts)
+{
+	for (unsigned i = 0; i < count; ++i)
+		counts[i] = escapeTime<EscapeTimeTraits<float> >(cx[i], cy, resolution);
+}
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ *  MandelbrotRendererDouble.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef MANDELBROT_RENDERER_DOUBLE_HPP
+#define MANDELBROT_RENDERER_DOUBLE_HPP
+
+#ifdef OMP_BUILD
+
+#include "IRenderer.hpp"
+#include "CoordinateGenerator.hpp"
+#include "LaneQueue.hpp"
+
+// Escape time renderer in double, for the shallow zooms up to about
+// 1e13. Pixels are iterated 8 at a time in AVX-512 registers or 4 at a
+// time in AVX2 registers, with FMA, whichever the CPU has; one at a
+// time otherwise. The lanes are refilled from the row as soon as their
+// pixel is done, see LaneQueue.hpp.
+// Frames whose pixel spacing float still resolves, with the same guard
+// bits as the automatic mode, are iterated in float instead: twice the
+// lanes per register, 16 or 8.
+class MandelbrotRendererDouble : public IRenderer {
+public:
+	virtual void render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
+					   mpfreal& zoom, int resolution, mpfreal& x, mpfreal& y);
+
+	// Escape counts of count pixels of coordinates (cx[i], cy). The SIMD
+	// kernels add the lane iterations they ran to usage.
+	static void iterate(const double* cx, double cy, unsigned count, int resolution, int* counts,
+						LaneQueue::LaneUsage& usage);
+	static void iterate(const float* cx, float cy, unsigned count, int resolution, int* counts,
+						LaneQueue::LaneUsage& usage);
+
+private:
+	// Whether float resolves the pixel spacing of the computed frame
+	bool _fitsFloat() const;
+
+	template <typename T>
+	void _render(unsigned char *pixelBuffer, unsigned width, unsigned heigth, int resolution);
+
+	static void _iterateScalar(const double* cx, double cy, unsigned count, int resolution, int* counts);
+	static void _iterateScalar(const float* cx, float cy, unsigned count, int resolution, int* counts);
+
+	// Built with AVX2 code generation, in MandelbrotRendererDoubleAVX2.cpp
+	static void _iterateAVX2(const double* cx, double cy, unsigned count, int resolution, int* counts,
+							 LaneQueue::LaneUsage& usage);
+	static void _iterateAVX2(const float* cx, float cy, unsigned count, int resolution, int* counts,
+							 LaneQueue::LaneUsage& usage);
+
+	// Built with AVX-512 code generation, in MandelbrotRendererDoubleAVX512.cpp
+	static void _iterateAVX512(const double* cx, double cy, unsigned count, int resolution, int* counts,
+							   LaneQueue::LaneUsage& usage);
+	static void _iterateAVX512(const float* cx, float cy, unsigned count, int resolution, int* counts,
+							   LaneQueue::LaneUsage& usage);
+
+	CoordinateGenerator m_coordinates;
+};
+
+#endif
+
+#endif
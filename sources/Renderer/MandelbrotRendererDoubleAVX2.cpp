@@ -0,0 +1,123 @@
+/*
+ *  MandelbrotRendererDoubleAVX2.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "../Common.hpp"
+
+#ifdef OMP_BUILD
+
+#include "MandelbrotRendererDouble.hpp"
+
+// This file is built with AVX2 code generation (per file setting in the
+// project) and must only be entered once CpuFeatures::hasAVX2() said yes
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+namespace {
+	// 4 doubles; two vectors of them run side by side so that the latency
+	// of the multiplications of one hides behind the other
+	struct AVX2Lanes
+	{
+		typedef double Scalar;
+		typedef __m256d Vector;
+		static const int Count = 4;
+
+		static Vector set1(double x) { return _mm256_set1_pd(x); }
+		static Vector load(const double* x) { return _mm256_loadu_pd(x); }
+		static void store(double* x, Vector a) { _mm256_storeu_pd(x, a); }
+		static Vector add(Vector a, Vector b) { return _mm256_add_pd(a, b); }
+		static Vector sub(Vector a, Vector b) { return _mm256_sub_pd(a, b); }
+		static Vector mul(Vector a, Vector b) { return _mm256_mul_pd(a, b); }
+		static Vector fmadd(Vector a, Vector b, Vector c) { return _mm256_fmadd_pd(a, b, c); }
+
+		static unsigned escaped(Vector norm)
+		{
+			return (unsigned)_mm256_movemask_pd(_mm256_cmp_pd(norm, _mm256_set1_pd(4.0), _CMP_NLE_UQ));
+		}
+
+		static unsigned equal(Vector a, Vector b)
+		{
+			return (unsigned)_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ));
+		}
+	};
+
+	// 8 floats, for the views float is precise enough for
+	struct AVX2FloatLanes
+	{
+		typedef float Scalar;
+		typedef __m256 Vector;
+		static const int Count = 8;
+
+		static Vector set1(float x) { return _mm256_set1_ps(x); }
+		static Vector load(const float* x) { return _mm256_loadu_ps(x); }
+		static void store(float* x, Vector a) { _mm256_storeu_ps(x, a); }
+		static Vector add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+		static Vector sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+		static Vector mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+		static Vector fmadd(Vector a, Vector b, Vector c) { return _mm256_fmadd_ps(a, b, c); }
+
+		static unsigned escaped(Vector norm)
+		{
+			return (unsigned)_mm256_movemask_ps(_mm256_cmp_ps(norm, _mm256_set1_ps(4.0f), _CMP_NLE_UQ));
+		}
+
+		static unsigned equal(Vector a, Vector b)
+		{
+			return (unsigned)_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+		}
+	};
+}
+
+void MandelbrotRendererDouble::_iterateAVX2(const double* cx, double cy, unsigned count, int resolution, int* counts,
+											LaneQueue::LaneUsage& usage)
+{
+	LaneQueue::iterateRow<AVX2Lanes, 2>(cx, cy, count, resolution, counts, usage);
+}
+
+void MandelbrotRendererDouble::_iterateAVX2(const float* cx, float cy, unsigned count, int resolution, int* counts,
+											LaneQueue::LaneUsage& usage)
+{
+	LaneQueue::iterateRow<AVX2FloatLanes, 2>(cx, cy, count, resolution, counts, usage);
+}
+
+#else
+
+// Built without AVX2 code generation: fall back to the scalar loop
+void MandelbrotRendererDouble::_iterateAVX2(const double* cx, double cy, unsigned count, int resolution, int* counts,
+											LaneQueue::LaneUsage&)
+{
+	_iterateScalar(cx, cy, count, resolution, counts);
+}
+
+void MandelbrotRendererDouble::_iterateAVX2(const float* cx, float cy, unsigned count, int resolution, int* counts,
+											LaneQueue::LaneUsage&)
+{
+	_iterateScalar(cx, cy, count, resolution, counts);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,132 @@
+/*
+ *  MandelbrotRendererDoubleAVX512.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "../Common.hpp"
+
+#ifdef OMP_BUILD
+
+#include "MandelbrotRendererDouble.hpp"
+#include "../CpuFeatures.hpp"
+
+// This file is built with AVX-512 code generation (per file setting in
+// the project, Visual Studio 2017 and later) and must only be entered
+// once CpuFeatures::hasAVX512() said yes
+
+#ifdef __AVX512F__
+
+#include <immintrin.h>
+
+namespace {
+	// 8 doubles; two vectors of them run side by side so that the latency
+	// of the multiplications of one hides behind the other
+	struct AVX512Lanes
+	{
+		typedef double Scalar;
+		typedef __m512d Vector;
+		static const int Count = 8;
+
+		static Vector set1(double x) { return _mm512_set1_pd(x); }
+		static Vector load(const double* x) { return _mm512_loadu_pd(x); }
+		static void store(double* x, Vector a) { _mm512_storeu_pd(x, a); }
+		static Vector add(Vector a, Vector b) { return _mm512_add_pd(a, b); }
+		static Vector sub(Vector a, Vector b) { return _mm512_sub_pd(a, b); }
+		static Vector mul(Vector a, Vector b) { return _mm512_mul_pd(a, b); }
+		static Vector fmadd(Vector a, Vector b, Vector c) { return _mm512_fmadd_pd(a, b, c); }
+
+		static unsigned escaped(Vector norm)
+		{
+			return (unsigned)_mm512_cmp_pd_mask(norm, _mm512_set1_pd(4.0), _CMP_NLE_UQ);
+		}
+
+		static unsigned equal(Vector a, Vector b)
+		{
+			return (unsigned)_mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ);
+		}
+	};
+
+	// 16 floats, for the views float is precise enough for
+	struct AVX512FloatLanes
+	{
+		typedef float Scalar;
+		typedef __m512 Vector;
+		static const int Count = 16;
+
+		static Vector set1(float x) { return _mm512_set1_ps(x); }
+		static Vector load(const float* x) { return _mm512_loadu_ps(x); }
+		static void store(float* x, Vector a) { _mm512_storeu_ps(x, a); }
+		static Vector add(Vector a, Vector b) { return _mm512_add_ps(a, b); }
+		static Vector sub(Vector a, Vector b) { return _mm512_sub_ps(a, b); }
+		static Vector mul(Vector a, Vector b) { return _mm512_mul_ps(a, b); }
+		static Vector fmadd(Vector a, Vector b, Vector c) { return _mm512_fmadd_ps(a, b, c); }
+
+		static unsigned escaped(Vector norm)
+		{
+			return (unsigned)_mm512_cmp_ps_mask(norm, _mm512_set1_ps(4.0f), _CMP_NLE_UQ);
+		}
+
+		static unsigned equal(Vector a, Vector b)
+		{
+			return (unsigned)_mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ);
+		}
+	};
+}
+
+void MandelbrotRendererDouble::_iterateAVX512(const double* cx, double cy, unsigned count, int resolution, int* counts,
+											  LaneQueue::LaneUsage& usage)
+{
+	LaneQueue::iterateRow<AVX512Lanes, 2>(cx, cy, count, resolution, counts, usage);
+}
+
+void MandelbrotRendererDouble::_iterateAVX512(const float* cx, float cy, unsigned count, int resolution, int* counts,
+											  LaneQueue::LaneUsage& usage)
+{
+	LaneQueue::iterateRow<AVX512FloatLanes, 2>(cx, cy, count, resolution, counts, usage);
+}
+
+#else
+
+// Built without AVX-512 code generation: fall back to the AVX2 kernel
+// when the CPU has it, the scalar loop otherwise
+void MandelbrotRendererDouble::_iterateAVX512(const double* cx, double cy, unsigned count, int resolution, int* counts,
+											  LaneQueue::LaneUsage& usage)
+{
+	if (CpuFeatures::hasAVX2())
+		_iterateAVX2(cx, cy, count, resolution, counts, usage);
+	else
+		_iterateScalar(cx, cy, count, resolution, counts);
+}
+
+void MandelbrotRendererDouble::_iterateAVX512(const float* cx, float cy, unsigned count, int resolution, int* counts,
+											  LaneQueue::LaneUsage& usage)
+{
+	if (CpuFeatures::hasAVX2())
+		_iterateAVX2(cx, cy, count, resolution, counts, usage);
+	else
+		_iterateScalar(cx, cy, count, resolution, counts);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ *  MandelbrotRendererDoubleDouble.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "../Common.hpp"
+
+#ifdef OMP_BUILD
+
+#include "MandelbrotRendererDoubleDouble.hpp"
+#include "EscapeTime.hpp"
+#include "../CpuFeatures.hpp"
+#include <vector>
+
+void MandelbrotRendererDoubleDouble::render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
+	mpfreal& zoom, int resolution, mpfreal& x, mpfreal& y)
+{
+	m_coordinates.compute(width, heigth, zoom, x, y);
+
+	// Column and row coordinates, the only mpf work of the frame
+	std::vector<doubledouble> columns;
+	std::vector<doubledouble> rows;
+
+	m_coordinates.getColumns(columns);
+	m_coordinates.getRows(rows);
+
+	long long interior = 0;
+
+	#pragma omp parallel for schedule(dynamic) reduction(+:interior)
+	for (int image_y = 0; image_y < (int)heigth; ++image_y)
+	{
+		std::vector<int> counts(width);
+		std::vector<unsigned> outside;
+
+		interior += findInterior<EscapeTimeTraits<doubledouble> >(&columns[0], rows[image_y], width, resolution,
+																   &counts[0], outside);
+
+		// The pixels left to iterate, side by side for the AVX2 kernel
+		const unsigned count = (unsigned)outside.size();
+		std::vector<doubledouble> cx(count);
+		std::vector<doubledouble> cy(count, rows[image_y]);
+		std::vector<int> outsideCounts(count);
+
+		for (unsigned i = 0; i < count; ++i)
+			cx[i] = columns[outside[i]];
+
+		if (count > 0)
+			iterate(&cx[0], &cy[0], count, resolution, &outsideCounts[0]);
+
+		for (unsigned i = 0; i < count; ++i)
+			counts[outside[i]] = outsideCounts[i];
+
+		for (unsigned image_x = 0; image_x < width; ++image_x)
+			setEscapeColor(pixelBuffer + (image_y * width + image_x) * 4, counts[image_x], resolution);
+	}
+
+	m_statistics = RenderStatistics();
+	m_statistics.interiorPixels = (unsigned)interior;
+}
+
+void MandelbrotRendererDoubleDouble::iterate(const doubledouble* cx, const doubledouble* cy, unsigned count,
+											 int resolution, int* counts)
+{
+	if (CpuFeatures::hasAVX2())
+		_iterateAVX2(cx, cy, count, resolution, counts);
+	else
+		_iterateScalar(cx, cy, count, resolution, counts);
+}
+
+void MandelbrotRendererDoubleDouble::_iterateScalar(const doubledouble* cx, const doubledouble* cy, unsigned count,
+													int resolution, int* counts)
+{
+	for (unsigned i = 0; i < count; ++i)
+		counts[i] = escapeTime<EscapeTimeTraits<doubledouble> >(cx[i], cy[i], resolution);
+}
+
+#endif
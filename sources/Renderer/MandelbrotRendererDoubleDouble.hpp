@@ -0,0 +1,61 @@
+/*
+ *  MandelbrotRendererDoubleDouble.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef MANDELBROT_RENDERER_DOUBLE_DOUBLE_HPP
+#define MANDELBROT_RENDERER_DOUBLE_DOUBLE_HPP
+
+#ifdef OMP_BUILD
+
+#include "IRenderer.hpp"
+#include "CoordinateGenerator.hpp"
+#include "../Real/doubledouble.hpp"
+
+// Escape time renderer in double-double (~106 bits), for the zooms
+// between 1e13 and 1e28 where double pixelates and mpf is overkill.
+// Pixels are iterated 4 at a time in AVX2 registers when the CPU has
+// them, one at a time otherwise.
+class MandelbrotRendererDoubleDouble : public IRenderer {
+public:
+	virtual void render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
+					   mpfreal& zoom, int resolution, mpfreal& x, mpfreal& y);
+
+	// Escape counts of count pixels of coordinates (cx[i], cy[i])
+	static void iterate(const doubledouble* cx, const doubledouble* cy, unsigned count,
+						int resolution, int* counts);
+
+private:
+	static void _iterateScalar(const doubledouble* cx, const doubledouble* cy, unsigned count,
+							   int resolution, int* counts);
+
+	// Built with AVX2 code generation, in MandelbrotRendererDoubleDoubleAVX2.cpp
+	static void _iterateAVX2(const doubledouble* cx, const doubledouble* cy, unsigned count,
+							 int resolution, int* counts);
+
+	CoordinateGenerator m_coordinates;
+};
+
+#endif
+
+#endif
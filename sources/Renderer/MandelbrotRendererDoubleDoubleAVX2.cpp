@@ -0,0 +1,170 @@
+/*
+ *  MandelbrotRendererDoubleDoubleAVX2.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "../Common.hpp"
+
+#ifdef OMP_BUILD
+
+#include "MandelbrotRendererDoubleDouble.hpp"
+
+// This file is built with AVX2 code generation (per file setting in the
+// project) and must only be entered once CpuFeatures::hasAVX2() said yes
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+namespace {
+	// 4 double-doubles, one per lane
+	struct dd4
+	{
+		__m256d hi;
+		__m256d lo;
+	};
+
+	inline dd4 quickTwoSum(__m256d a, __m256d b)
+	{
+		dd4 r;
+		r.hi = _mm256_add_pd(a, b);
+		r.lo = _mm256_sub_pd(b, _mm256_sub_pd(r.hi, a));
+		return r;
+	}
+
+	inline dd4 add(const dd4& x, const dd4& y)
+	{
+		const __m256d s = _mm256_add_pd(x.hi, y.hi);
+		const __m256d bb = _mm256_sub_pd(s, x.hi);
+		__m256d e = _mm256_add_pd(_mm256_sub_pd(x.hi, _mm256_sub_pd(s, bb)), _mm256_sub_pd(y.hi, bb));
+		e = _mm256_add_pd(e, _mm256_add_pd(x.lo, y.lo));
+		return quickTwoSum(s, e);
+	}
+
+	inline dd4 sub(const dd4& x, const dd4& y)
+	{
+		const __m256d s = _mm256_sub_pd(x.hi, y.hi);
+		const __m256d bb = _mm256_sub_pd(s, x.hi);
+		__m256d e = _mm256_sub_pd(_mm256_sub_pd(x.hi, _mm256_sub_pd(s, bb)), _mm256_add_pd(y.hi, bb));
+		e = _mm256_add_pd(e, _mm256_sub_pd(x.lo, y.lo));
+		return quickTwoSum(s, e);
+	}
+
+	// The FMA gives the rounding error of a product exactly
+	inline dd4 mul(const dd4& x, const dd4& y)
+	{
+		const __m256d p = _mm256_mul_pd(x.hi, y.hi);
+		__m256d e = _mm256_fmsub_pd(x.hi, y.hi, p);
+		e = _mm256_fmadd_pd(x.hi, y.lo, e);
+		e = _mm256_fmadd_pd(x.lo, y.hi, e);
+		return quickTwoSum(p, e);
+	}
+
+	inline dd4 sqr(const dd4& x)
+	{
+		const __m256d p = _mm256_mul_pd(x.hi, x.hi);
+		__m256d e = _mm256_fmsub_pd(x.hi, x.hi, p);
+		e = _mm256_fmadd_pd(_mm256_add_pd(x.hi, x.hi), x.lo, e);
+		return quickTwoSum(p, e);
+	}
+
+	inline dd4 mul2(const dd4& x)
+	{
+		dd4 r;
+		r.hi = _mm256_add_pd(x.hi, x.hi);
+		r.lo = _mm256_add_pd(x.lo, x.lo);
+		return r;
+	}
+
+	inline dd4 load(const doubledouble* values)
+	{
+		dd4 r;
+		r.hi = _mm256_set_pd(values[3].high(), values[2].high(), values[1].high(), values[0].high());
+		r.lo = _mm256_set_pd(values[3].low(), values[2].low(), values[1].low(), values[0].low());
+		return r;
+	}
+}
+
+void MandelbrotRendererDoubleDouble::_iterateAVX2(const doubledouble* cx, const doubledouble* cy, unsigned count,
+												  int resolution, int* counts)
+{
+	const __m256d four = _mm256_set1_pd(4.0);
+	const __m256d one = _mm256_set1_pd(1.0);
+
+	for (unsigned first = 0; first < count; first += 4)
+	{
+		// Pad the last group with copies of its first pixel
+		doubledouble laneX[4], laneY[4];
+		for (unsigned lane = 0; lane < 4; ++lane)
+		{
+			const unsigned i = (first + lane < count) ? first + lane : first;
+			laneX[lane] = cx[i];
+			laneY[lane] = cy[i];
+		}
+
+		const dd4 c_x = load(laneX);
+		const dd4 c_y = load(laneY);
+		dd4 zx = c_x;
+		dd4 zy = c_y;
+
+		// All ones while the lane has not escaped
+		__m256d active = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+		__m256d iterations = _mm256_setzero_pd();
+
+		for (int iteration = 0; iteration < resolution; ++iteration)
+		{
+			const dd4 x2 = sqr(zx);
+			const dd4 y2 = sqr(zy);
+
+			const __m256d norm = _mm256_add_pd(x2.hi, y2.hi);
+			active = _mm256_and_pd(active, _mm256_cmp_pd(norm, four, _CMP_LE_OQ));
+
+			if (_mm256_movemask_pd(active) == 0)
+				break;
+
+			iterations = _mm256_add_pd(iterations, _mm256_and_pd(active, one));
+
+			zy = add(mul2(mul(zx, zy)), c_y);
+			zx = add(sub(x2, y2), c_x);
+		}
+
+		double laneIterations[4];
+		_mm256_storeu_pd(laneIterations, iterations);
+
+		for (unsigned lane = 0; lane < 4 && first + lane < count; ++lane)
+			counts[first + lane] = (int)laneIterations[lane];
+	}
+}
+
+#else
+
+// Built without AVX2 code generation: fall back to the scalar loop
+void MandelbrotRendererDoubleDouble::_iterateAVX2(const doubledouble* cx, const doubledouble* cy, unsigned count,
+												  int resolution, int* counts)
+{
+	_iterateScalar(cx, cy, count, resolution, counts);
+}
+
+#endif
+
+#endif
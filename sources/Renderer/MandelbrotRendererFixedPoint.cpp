@@ -0,0 +1,239 @@
+/*
+ *  MandelbrotRendererFixedPoint.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "../Common.hpp"
+
+#ifdef OMP_BUILD
+
+#include "MandelbrotRendererFixedPoint.hpp"
+#include "../Real/FPRealConversion.hpp"
+#include "../CpuFeatures.hpp"
+#include "CoordinateGenerator.hpp"
+#include "FixedPointBatch.hpp"
+#include <algorithm>
+#include <vector>
+
+const MandelbrotRendererFixedPoint::RenderFunction MandelbrotRendererFixedPoint::s_renderFunctions[] = {
+	&MandelbrotRendererFixedPoint::_render<2>,
+	&MandelbrotRendererFixedPoint::_render<3>,
+	&MandelbrotRendererFixedPoint::_render<4>,
+	&MandelbrotRendererFixedPoint::_render<5>,
+	&MandelbrotRendererFixedPoint::_render<6>,
+	&MandelbrotRendererFixedPoint::_render<7>,
+	&MandelbrotRendererFixedPoint::_render<8>,
+	&MandelbrotRendererFixedPoint::_render<9>
+};
+
+void MandelbrotRendererFixedPoint::render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
+	mpfreal& zoom, int resolution, mpfreal& x, mpfreal& y)
+{
+	const int words = requiredWords();
+
+	if (words == 0)
+	{
+		m_multiPrecision.render(pixelBuffer, width, heigth, zoom, resolution, x, y);
+		m_statistics = m_multiPrecision.getStatistics();
+		return;
+	}
+
+	(this->*s_renderFunctions[words - MinWords])(pixelBuffer, width, heigth, zoom, resolution, x, y);
+}
+
+int MandelbrotRendererFixedPoint::requiredWords()
+{
+	// One word for the integer part, the mpf mantissa bits after it
+	const int words = 1 + int((mpf_get_default_prec() + 63) / 64);
+
+	if (words > MaxWords)
+		return 0;
+
+	return std::max(words, (int)MinWords);
+}
+
+MandelbrotRendererFixedPoint::BatchKernel MandelbrotRendererFixedPoint::batchKernel()
+{
+	if (CpuFeatures::hasAVX512IFMA())
+		return IFMAKernel;
+
+	if (CpuFeatures::hasAVX512())
+		return AVX512Kernel;
+
+	if (CpuFeatures::hasAVX2())
+		return AVX2Kernel;
+
+	return ScalarKernel;
+}
+
+int MandelbrotRendererFixedPoint::_digitBits(BatchKernel kernel)
+{
+	return (kernel == IFMAKernel) ? 52 : 32;
+}
+
+int MandelbrotRendererFixedPoint::_digitCount(int words, BatchKernel kernel)
+{
+	// The integer digit, then enough digits for the fraction words
+	const int bits = _digitBits(kernel);
+	return 1 + (64 * (words - 1) + bits - 1) / bits;
+}
+
+void MandelbrotRendererFixedPoint::_iterateRow(BatchKernel kernel, const uint64* columns, const uint64* row,
+	unsigned width, int digits, int resolution, int* counts)
+{
+	switch (kernel)
+	{
+		case IFMAKernel:
+			_iterateRowIFMA(columns, row, width, digits, resolution, counts);
+			break;
+
+		case AVX512Kernel:
+			_iterateRowAVX512(columns, row, width, digits, resolution, counts);
+			break;
+
+		case AVX2Kernel:
+			_iterateRowAVX2(columns, row, width, digits, resolution, counts);
+			break;
+
+		default:
+			FixedPointBatch::iterateRow<FixedPointBatch::ScalarLanes<32> >(columns, row, width, digits, resolution, counts);
+			break;
+	}
+}
+
+template <int N>
+void MandelbrotRendererFixedPoint::_render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
+	const mpfreal& zoom, int resolution, const mpfreal& x, const mpfreal& y)
+{
+	typedef FPReal<N, Limb> Real;
+
+	// zoom_y = zoom * double(heigth / 2.4) like the mpf engine. The zoom
+	// only has a double mantissa, its power of two becomes a shift.
+	const floatexp zoomExp = zoom.get<floatexp>();
+	const Real scale(double(heigth) / 2.4);
+	Real zoom_y, step;
+	mul(zoom_y, scale, Real(zoomExp.mantissa()));
+	inv(step, zoom_y);
+	step.mul2k(-(int)zoomExp.exponent());
+
+	// origin = (zoom * width * x - width / 2) / zoom_y + FractalLeft
+	//        = width * x / scale - (width / 2) * step + FractalLeft
+	Real position, originX, originY, offset;
+
+	toFPReal(position, *x);
+	position.mul((int)width);
+	div(originX, position, scale);
+	offset = step;
+	offset.mul((int)width / 2);
+	originX.sub(offset);
+	originX.add(Real(CoordinateGenerator::FractalLeft));
+
+	toFPReal(position, *y);
+	position.mul((int)heigth);
+	div(originY, position, scale);
+	offset = step;
+	offset.mul((int)heigth / 2);
+	originY.sub(offset);
+	originY.add(Real(CoordinateGenerator::FractalBottom));
+
+	std::vector<Real> columns;
+	std::vector<Real> rows;
+	_generate(columns, width, originX, step);
+	_generate(rows, heigth, originY, step);
+
+	const BatchKernel kernel = (N <= MaxBatchWords) ? batchKernel() : ScalarKernel;
+
+	if (kernel != ScalarKernel)
+	{
+		_renderBatch(pixelBuffer, width, heigth, resolution, columns, rows, kernel);
+		return;
+	}
+
+	m_statistics = RenderStatistics();
+	m_statistics.interiorPixels = renderEscapeTime<EscapeTimeTraits<Real> >(pixelBuffer, width, heigth, resolution,
+																			columns, rows);
+}
+
+template <int N>
+void MandelbrotRendererFixedPoint::_renderBatch(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
+	int resolution, const std::vector<FPReal<N, Limb> >& columns, const std::vector<FPReal<N, Limb> >& rows,
+	BatchKernel kernel)
+{
+	// The columns are shared by every row, converted once
+	const int digits = _digitCount(N, kernel);
+	std::vector<uint64> columnDigits(width * digits);
+
+	for (unsigned image_x = 0; image_x < width; ++image_x)
+		_toDigits(&columnDigits[image_x * digits], columns[image_x], kernel);
+
+	long long interior = 0;
+
+	#pragma omp parallel for schedule(dynamic) reduction(+:interior)
+	for (int image_y = 0; image_y < (int)heigth; ++image_y)
+	{
+		std::vector<uint64> rowDigits(digits);
+		std::vector<int> counts(width);
+		std::vector<unsigned> outside;
+
+		interior += findInterior<EscapeTimeTraits<FPReal<N, Limb> > >(&columns[0], rows[image_y], width, resolution,
+																	   &counts[0], outside);
+
+		// Digits of the columns left to iterate, side by side for the kernel
+		const unsigned count = (unsigned)outside.size();
+		std::vector<uint64> outsideDigits(count * digits);
+		std::vector<int> outsideCounts(count);
+
+		for (unsigned i = 0; i < count; ++i)
+			std::copy(&columnDigits[outside[i] * digits], &columnDigits[outside[i] * digits] + digits,
+					  &outsideDigits[i * digits]);
+
+		_toDigits(&rowDigits[0], rows[image_y], kernel);
+		if (count > 0)
+			_iterateRow(kernel, &outsideDigits[0], &rowDigits[0], count, digits, resolution, &outsideCounts[0]);
+
+		for (unsigned i = 0; i < count; ++i)
+			counts[outside[i]] = outsideCounts[i];
+
+		for (unsigned image_x = 0; image_x < width; ++image_x)
+			setEscapeColor(pixelBuffer + (image_y * width + image_x) * 4, counts[image_x], resolution);
+	}
+
+	m_statistics = RenderStatistics();
+	m_statistics.interiorPixels = (unsigned)interior;
+}
+
+template <int N>
+void MandelbrotRendererFixedPoint::_generate(std::vector<FPReal<N, Limb> >& coordinates, unsigned count,
+	const FPReal<N, Limb>& origin, const FPReal<N, Limb>& step)
+{
+	coordinates.resize(count);
+
+	FPReal<N, Limb> accumulator(origin);
+	for (unsigned i = 0; i < count; ++i)
+	{
+		coordinates[i] = accumulator;
+		accumulator.add(step);
+	}
+}
+
+#endif
@@ -0,0 +1,188 @@
+/*
+ *  MandelbrotRendererFixedPoint.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef MANDELBROT_RENDERER_FIXED_POINT_HPP
+#define MANDELBROT_RENDERER_FIXED_POINT_HPP
+
+#ifdef OMP_BUILD
+
+#include "IRenderer.hpp"
+#include <vector>
+#include "MandelbrotRenderer.hpp"
+#include "../Real/FPReal.hpp"
+#include "EscapeTime.hpp"
+
+// Escape time renderer in FPReal<N>, a fixed point real over N 64-bit
+// words: no normalization and no heap, every operation is a plain loop
+// over the words. N follows the mpf precision of the frame, from 2 to
+// 9 words (512 fractional bits); deeper frames go through mpf.
+// Coordinates are set up in fixed point as well, mpf only hands over
+// the view position.
+// Up to MaxBatchWords words (256 fractional bits, zooms to about 1e50)
+// pixels go through the limb sliced kernels of FixedPointBatch.hpp, 4
+// or 8 at a time, when the CPU has AVX2 or AVX-512.
+class MandelbrotRendererFixedPoint : public IRenderer {
+public:
+	typedef uint64 Limb;
+	static const int MinWords = 2;
+	static const int MaxWords = 9;
+	static const int MaxBatchWords = 5;
+
+	enum BatchKernel {
+		ScalarKernel,
+		AVX2Kernel,		// 4 lanes of 32-bit digits
+		AVX512Kernel,	// 8 lanes of 32-bit digits
+		IFMAKernel		// 8 lanes of 52-bit digits
+	};
+
+	virtual void render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
+					   mpfreal& zoom, int resolution, mpfreal& x, mpfreal& y);
+
+	// Words needed for the current mpf precision, 0 when beyond MaxWords
+	static int requiredWords();
+
+	// Escape count of the pixel of coordinates (cx, cy)
+	template <int N, typename Word>
+	static int iterate(const FPReal<N, Word>& cx, const FPReal<N, Word>& cy, int resolution);
+
+	// Widest batch kernel the CPU runs
+	static BatchKernel batchKernel();
+
+	// Escape counts of the pixels (cx[i], cy) for i in [0, count), through
+	// KERNEL. N must not exceed MaxBatchWords.
+	template <int N>
+	static void iterateBatch(BatchKernel kernel, const FPReal<N, Limb>* cx, unsigned count,
+							 const FPReal<N, Limb>& cy, int resolution, int* counts);
+
+private:
+	template <int N>
+	void _render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
+				 const mpfreal& zoom, int resolution, const mpfreal& x, const mpfreal& y);
+
+	// Rows through the batch kernel KERNEL
+	template <int N>
+	void _renderBatch(unsigned char *pixelBuffer, unsigned width, unsigned heigth, int resolution,
+					  const std::vector<FPReal<N, Limb> >& columns, const std::vector<FPReal<N, Limb> >& rows,
+					  BatchKernel kernel);
+
+	// Origin + i * step for i in [0, count), additions are exact
+	template <int N>
+	static void _generate(std::vector<FPReal<N, Limb> >& coordinates, unsigned count,
+						  const FPReal<N, Limb>& origin, const FPReal<N, Limb>& step);
+
+	// Digits of X for KERNEL: DIGITS numbers of the kernel's digit bits,
+	// integer first, in two's complement
+	template <int N>
+	static void _toDigits(uint64* digits, const FPReal<N, Limb>& x, BatchKernel kernel);
+	static int _digitBits(BatchKernel kernel);
+	static int _digitCount(int words, BatchKernel kernel);
+
+	// Escape counts of one row, COLUMNS holding the digits of WIDTH
+	// pixels and ROW those of their y
+	static void _iterateRow(BatchKernel kernel, const uint64* columns, const uint64* row, unsigned width,
+							int digits, int resolution, int* counts);
+
+	// Built with AVX2 code generation, in MandelbrotRendererFixedPointAVX2.cpp
+	static void _iterateRowAVX2(const uint64* columns, const uint64* row, unsigned width,
+								int digits, int resolution, int* counts);
+
+	// Built with AVX-512 code generation, in MandelbrotRendererFixedPointAVX512.cpp
+	static void _iterateRowAVX512(const uint64* columns, const uint64* row, unsigned width,
+								  int digits, int resolution, int* counts);
+	static void _iterateRowIFMA(const uint64* columns, const uint64* row, unsigned width,
+								int digits, int resolution, int* counts);
+
+	typedef void (MandelbrotRendererFixedPoint::*RenderFunction)(unsigned char*, unsigned, unsigned,
+																 const mpfreal&, int, const mpfreal&, const mpfreal&);
+	static const RenderFunction s_renderFunctions[MaxWords - MinWords + 1];
+
+	MandelbrotRenderer m_multiPrecision;
+};
+
+template <int N, typename Word>
+int MandelbrotRendererFixedPoint::iterate(const FPReal<N, Word>& cx, const FPReal<N, Word>& cy, int resolution)
+{
+	return escapeTime<EscapeTimeTraits<FPReal<N, Word> > >(cx, cy, resolution);
+}
+
+template <int N>
+void MandelbrotRendererFixedPoint::iterateBatch(BatchKernel kernel, const FPReal<N, Limb>* cx, unsigned count,
+	const FPReal<N, Limb>& cy, int resolution, int* counts)
+{
+	const int digits = _digitCount(N, kernel);
+	std::vector<uint64> columns(count * digits);
+	std::vector<uint64> row(digits);
+
+	for (unsigned i = 0; i < count; ++i)
+		_toDigits(&columns[i * digits], cx[i], kernel);
+	_toDigits(&row[0], cy, kernel);
+
+	_iterateRow(kernel, &columns[0], &row[0], count, digits, resolution, counts);
+}
+
+template <int N>
+void MandelbrotRendererFixedPoint::_toDigits(uint64* digits, const FPReal<N, Limb>& x, BatchKernel kernel)
+{
+	const int bits = _digitBits(kernel);
+	const int count = _digitCount(N, kernel);
+	const uint64 mask = (((uint64)1) << bits) - 1;
+	const Limb* words = x.words();
+
+	if (x.isZero())
+	{
+		for (int k = 0; k < count; ++k)
+			digits[k] = 0;
+		return;
+	}
+
+	// The fraction bits are read from the words most significant first
+	digits[0] = words[0] & mask;
+	for (int k = 1; k < count; ++k)
+	{
+		const int position = (k - 1) * bits;
+		const int word = 1 + position / 64;
+		const int offset = position % 64;
+
+		uint64 window = (word < N) ? words[word] << offset : 0;
+		if (offset > 0 && word + 1 < N)
+			window |= words[word + 1] >> (64 - offset);
+		digits[k] = window >> (64 - bits);
+	}
+
+	if (x.sgn() < 0)
+	{
+		uint64 carry = 1;
+		for (int k = count - 1; k >= 0; --k)
+		{
+			const uint64 s = (digits[k] ^ mask) + carry;
+			carry = s >> bits;
+			digits[k] = s & mask;
+		}
+	}
+}
+
+#endif
+
+#endif
@@ -0,0 +1,90 @@
+/*
+ *  MandelbrotRendererFixedPointAVX2.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "../Common.hpp"
+
+#ifdef OMP_BUILD
+
+#include "MandelbrotRendererFixedPoint.hpp"
+#include "FixedPointBatch.hpp"
+
+// This file is built with AVX2 code generation (per file setting in the
+// project) and must only be entered once CpuFeatures::hasAVX2() said yes
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+namespace {
+	// 4 lanes of 32-bit digits, the width of _mm256_mul_epu32
+	struct AVX2Lanes
+	{
+		typedef __m256i Vector;
+		static const int DigitBits = 32;
+		static const int Count = 4;
+
+		static Vector zero() { return _mm256_setzero_si256(); }
+		static Vector set1(uint64 x) { return _mm256_set1_epi64x((long long)x); }
+		static Vector load(const uint64* x) { return _mm256_loadu_si256((const __m256i*)x); }
+		static void store(uint64* x, Vector a) { _mm256_storeu_si256((__m256i*)x, a); }
+		static Vector add(Vector a, Vector b) { return _mm256_add_epi64(a, b); }
+		static Vector sub(Vector a, Vector b) { return _mm256_sub_epi64(a, b); }
+		static Vector andv(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+		static Vector orv(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+		static Vector xorv(Vector a, Vector b) { return _mm256_xor_si256(a, b); }
+		template <int S> static Vector shiftLeft(Vector a) { return _mm256_slli_epi64(a, S); }
+		template <int S> static Vector shiftRight(Vector a) { return _mm256_srli_epi64(a, S); }
+		static Vector equal(Vector a, Vector b) { return _mm256_cmpeq_epi64(a, b); }
+		static Vector greater(Vector a, Vector b) { return _mm256_cmpgt_epi64(a, b); }
+		static bool any(Vector a) { return !_mm256_testz_si256(a, a); }
+
+		static void multiplyAdd(Vector& lo, Vector& hi, Vector a, Vector b)
+		{
+			const __m256i p = _mm256_mul_epu32(a, b);
+			lo = _mm256_add_epi64(lo, _mm256_and_si256(p, _mm256_set1_epi64x(0xFFFFFFFF)));
+			hi = _mm256_add_epi64(hi, _mm256_srli_epi64(p, 32));
+		}
+	};
+}
+
+void MandelbrotRendererFixedPoint::_iterateRowAVX2(const uint64* columns, const uint64* row, unsigned width,
+												   int digits, int resolution, int* counts)
+{
+	FixedPointBatch::iterateRow<AVX2Lanes>(columns, row, width, digits, resolution, counts);
+}
+
+#else
+
+// Built without AVX2 code generation: fall back to the same kernel on
+// one pixel at a time
+void MandelbrotRendererFixedPoint::_iterateRowAVX2(const uint64* columns, const uint64* row, unsigned width,
+												   int digits, int resolution, int* counts)
+{
+	FixedPointBatch::iterateRow<FixedPointBatch::ScalarLanes<32> >(columns, row, width, digits, resolution, counts);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,129 @@
+/*
+ *  MandelbrotRendererFixedPointAVX512.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "../Common.hpp"
+
+#ifdef OMP_BUILD
+
+#include "MandelbrotRendererFixedPoint.hpp"
+#include "FixedPointBatch.hpp"
+
+// This file is built with AVX-512 code generation (per file setting in
+// the project, Visual Studio 2017 and later) and must only be entered
+// once CpuFeatures::hasAVX512() said yes, hasAVX512IFMA() for the IFMA
+// kernel. Compilers without the IFMA intrinsics run the 52-bit digits
+// one pixel at a time.
+
+#ifdef __AVX512F__
+
+#include <immintrin.h>
+
+#if defined(__AVX512IFMA__) || defined(_MSC_VER)
+#define FIXED_POINT_IFMA
+#endif
+
+namespace {
+	// 8 lanes of 32-bit digits. Comparisons give masks, turned back into
+	// all ones lanes for the generic kernel.
+	struct AVX512Lanes
+	{
+		typedef __m512i Vector;
+		static const int DigitBits = 32;
+		static const int Count = 8;
+
+		static Vector zero() { return _mm512_setzero_si512(); }
+		static Vector set1(uint64 x) { return _mm512_set1_epi64((long long)x); }
+		static Vector load(const uint64* x) { return _mm512_loadu_si512(x); }
+		static void store(uint64* x, Vector a) { _mm512_storeu_si512(x, a); }
+		static Vector add(Vector a, Vector b) { return _mm512_add_epi64(a, b); }
+		static Vector sub(Vector a, Vector b) { return _mm512_sub_epi64(a, b); }
+		static Vector andv(Vector a, Vector b) { return _mm512_and_si512(a, b); }
+		static Vector orv(Vector a, Vector b) { return _mm512_or_si512(a, b); }
+		static Vector xorv(Vector a, Vector b) { return _mm512_xor_si512(a, b); }
+		template <int S> static Vector shiftLeft(Vector a) { return _mm512_slli_epi64(a, S); }
+		template <int S> static Vector shiftRight(Vector a) { return _mm512_srli_epi64(a, S); }
+		static Vector equal(Vector a, Vector b) { return _mm512_maskz_set1_epi64(_mm512_cmpeq_epi64_mask(a, b), -1); }
+		static Vector greater(Vector a, Vector b) { return _mm512_maskz_set1_epi64(_mm512_cmpgt_epi64_mask(a, b), -1); }
+		static bool any(Vector a) { return _mm512_test_epi64_mask(a, a) != 0; }
+
+		static void multiplyAdd(Vector& lo, Vector& hi, Vector a, Vector b)
+		{
+			const __m512i p = _mm512_mul_epu32(a, b);
+			lo = _mm512_add_epi64(lo, _mm512_and_si512(p, _mm512_set1_epi64(0xFFFFFFFF)));
+			hi = _mm512_add_epi64(hi, _mm512_srli_epi64(p, 32));
+		}
+	};
+
+#ifdef FIXED_POINT_IFMA
+	// 8 lanes of 52-bit digits: the multiply-adds give both halves of the
+	// 104-bit product already split, a third fewer digits than AVX512Lanes
+	struct IFMALanes : public AVX512Lanes
+	{
+		static const int DigitBits = 52;
+
+		static void multiplyAdd(Vector& lo, Vector& hi, Vector a, Vector b)
+		{
+			lo = _mm512_madd52lo_epu64(lo, a, b);
+			hi = _mm512_madd52hi_epu64(hi, a, b);
+		}
+	};
+#endif
+}
+
+void MandelbrotRendererFixedPoint::_iterateRowAVX512(const uint64* columns, const uint64* row, unsigned width,
+													 int digits, int resolution, int* counts)
+{
+	FixedPointBatch::iterateRow<AVX512Lanes>(columns, row, width, digits, resolution, counts);
+}
+
+void MandelbrotRendererFixedPoint::_iterateRowIFMA(const uint64* columns, const uint64* row, unsigned width,
+												   int digits, int resolution, int* counts)
+{
+#ifdef FIXED_POINT_IFMA
+	FixedPointBatch::iterateRow<IFMALanes>(columns, row, width, digits, resolution, counts);
+#else
+	FixedPointBatch::iterateRow<FixedPointBatch::ScalarLanes<52> >(columns, row, width, digits, resolution, counts);
+#endif
+}
+
+#else
+
+// Built without AVX-512 code generation: fall back to the same kernels
+// on one pixel at a time
+void MandelbrotRendererFixedPoint::_iterateRowAVX512(const uint64* columns, const uint64* row, unsigned width,
+													 int digits, int resolution, int* counts)
+{
+	FixedPointBatch::iterateRow<FixedPointBatch::ScalarLanes<32> >(columns, row, width, digits, resolution, counts);
+}
+
+void MandelbrotRendererFixedPoint::_iterateRowIFMA(const uint64* columns, const uint64* row, unsigned width,
+												   int digits, int resolution, int* counts)
+{
+	FixedPointBatch::iterateRow<FixedPointBatch::ScalarLanes<52> >(columns, row, width, digits, resolution, counts);
+}
+
+#endif
+
+#endif
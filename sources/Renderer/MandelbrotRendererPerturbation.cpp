@@ -0,0 +1,362 @@
+/*
+ *  MandelbrotRendererPerturbation.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "../Common.hpp"
+
+#ifdef OMP_BUILD
+
+#include "MandelbrotRendererPerturbation.hpp"
+#include "EscapeTime.hpp"
+#include <cmath>
+#include <algorithm>
+#include <SFML/System/Clock.hpp>
+
+namespace {
+	// Pauldelbrot's criterion: once |Z + dz| gets that much smaller than
+	// |Z| (squared norms), dz no longer carries enough precision
+	const double glitchTolerance = 1e-6;
+
+	// Marks pixels glitched because the reference escaped before them
+	const double referenceEscaped = 1.0;
+
+	// Below this pixel spacing (~1e-289) dc and dz would soon fall into
+	// double's denormals: iterate them as floatexp
+	const floatexp::exp_t doubleMinStepExponent = -960;
+}
+
+MandelbrotRendererPerturbation::MandelbrotRendererPerturbation(const PerturbationSettings& settings) :
+m_settings(settings),
+m_pixelBuffer(NULL),
+m_width(0),
+m_heigth(0),
+m_resolution(0),
+m_step(0),
+m_glitchDepth(),
+m_unresolvedGlitches(),
+m_reference(),
+m_series(settings.seriesTerms),
+m_bla()
+{
+}
+
+void MandelbrotRendererPerturbation::render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
+	mpfreal& zoom, int resolution, mpfreal& x, mpfreal& y)
+{
+	std::vector<unsigned> pixels(width * heigth);
+
+	for (unsigned i = 0; i < pixels.size(); ++i)
+		pixels[i] = i;
+
+	m_coordinates.compute(width, heigth, zoom, x, y);
+	renderPixels(pixelBuffer, m_coordinates, resolution, pixels);
+}
+
+void MandelbrotRendererPerturbation::renderPixels(unsigned char *pixelBuffer, const CoordinateGenerator& coordinates, int resolution,
+												  const std::vector<unsigned>& framePixels)
+{
+	const unsigned width = coordinates.getWidth();
+	const unsigned heigth = coordinates.getHeigth();
+
+	// The reference sits on the center pixel, so every dc is a small
+	// integer multiple of the pixel spacing
+	const int center_x = (int)width / 2;
+	const int center_y = (int)heigth / 2;
+
+	m_pixelBuffer = pixelBuffer;
+	m_width = width;
+	m_heigth = heigth;
+	m_resolution = resolution;
+	m_step = coordinates.getStep().get<floatexp>();
+
+	m_reference.compute(coordinates.getX(center_x), coordinates.getY(center_y), resolution);
+	m_statistics.referenceCount = 1;
+
+	const floatexp radius = _frameRadius(center_x, center_y);
+
+	unsigned startIteration = 1;
+
+	if (m_settings.seriesApproximation)
+	{
+		// Probe the corners, the edges and a ring halfway to them: the
+		// series is only kept for as long as it matches all of them
+		const floatexp left = m_step * -center_x;
+		const floatexp right = m_step * ((int)width - 1 - center_x);
+		const floatexp top = m_step * -center_y;
+		const floatexp bottom = m_step * ((int)heigth - 1 - center_y);
+
+		std::vector<SeriesApproximation::complex> probes;
+		for (int i = 0; i < 3; ++i)
+			for (int j = 0; j < 3; ++j)
+			{
+				if (i == 1 && j == 1)
+					continue;
+
+				const floatexp px = (i == 0) ? left : (i == 1) ? floatexp() : right;
+				const floatexp py = (j == 0) ? top : (j == 1) ? floatexp() : bottom;
+				probes.push_back(SeriesApproximation::complex(px, py));
+				probes.push_back(SeriesApproximation::complex(px.mul2k(-1), py.mul2k(-1)));
+			}
+
+		m_series.compute(m_reference, radius, probes, resolution);
+		startIteration = m_series.getStartIteration();
+	}
+
+	m_statistics.iterationsSkipped = startIteration - 1;
+
+	if (m_settings.bilinearApproximation)
+	{
+		sf::Clock timer;
+		m_bla.compute(m_reference, radius);
+		m_statistics.blaBuildTime = timer.getElapsedTime();
+		m_statistics.blaMemoryUsage = m_bla.getMemoryUsage();
+	}
+
+	// Pixels the interior test settles are coloured now and left out of
+	// the perturbation passes
+	std::vector<double> columns;
+	std::vector<double> rows;
+	coordinates.getColumns(columns);
+	coordinates.getRows(rows);
+
+	std::vector<unsigned> pixels;
+	std::vector<unsigned> glitches;
+
+	m_statistics.interiorPixels = 0;
+	pixels.reserve(framePixels.size());
+
+	for (size_t i = 0; i < framePixels.size(); ++i)
+	{
+		if (isInMainComponents(columns[framePixels[i] % width], rows[framePixels[i] / width]))
+		{
+			setEscapeColor(m_pixelBuffer + framePixels[i] * 4, resolution, resolution);
+			++m_statistics.interiorPixels;
+		}
+		else
+			pixels.push_back(framePixels[i]);
+	}
+
+	m_glitchDepth.assign(width * heigth, -1.0);
+
+	_renderPixels(pixels, center_x, center_y, startIteration, glitches);
+	m_statistics.glitchedPixels = (unsigned)glitches.size();
+
+	while (!glitches.empty() && m_statistics.referenceCount < m_settings.maxReferences)
+	{
+		// The deepest point of a glitch is the closest we have to the
+		// feature the reference missed: put the next reference there
+		unsigned deepest = glitches[0];
+		for (size_t i = 1; i < glitches.size(); ++i)
+		{
+			if (m_glitchDepth[glitches[i]] < m_glitchDepth[deepest])
+				deepest = glitches[i];
+		}
+
+		const int reference_x = deepest % width;
+		const int reference_y = deepest / width;
+
+		m_reference.compute(coordinates.getX(reference_x), coordinates.getY(reference_y), resolution);
+		++m_statistics.referenceCount;
+
+		if (m_settings.bilinearApproximation)
+		{
+			sf::Clock timer;
+			m_bla.compute(m_reference, _frameRadius(reference_x, reference_y));
+			m_statistics.blaBuildTime += timer.getElapsedTime();
+		}
+
+		pixels.swap(glitches);
+		glitches.clear();
+
+		_renderPixels(pixels, reference_x, reference_y, 1, glitches);
+	}
+
+	m_statistics.unresolvedGlitches = (unsigned)glitches.size();
+	m_unresolvedGlitches.swap(glitches);
+}
+
+void MandelbrotRendererPerturbation::_renderPixels(const std::vector<unsigned>& pixels, int referenceX, int referenceY,
+												   unsigned startIteration, std::vector<unsigned>& glitches)
+{
+	if (m_step.exponent() < doubleMinStepExponent)
+		_iteratePixels<floatexp>(pixels, referenceX, referenceY, startIteration, glitches);
+	else
+		_iteratePixels<double>(pixels, referenceX, referenceY, startIteration, glitches);
+}
+
+template <typename T>
+void MandelbrotRendererPerturbation::_iteratePixels(const std::vector<unsigned>& pixels, int referenceX, int referenceY,
+													unsigned startIteration, std::vector<unsigned>& glitches)
+{
+	const ReferenceOrbit& Z = m_reference;
+	const unsigned lastIteration = Z.getLastIteration();
+	const OrbitPoint center = Z.getCenter();
+	const int resolution = m_resolution;
+	const T step = floatexp_cast<T>(m_step);
+	const bool useBLA = m_settings.bilinearApproximation;
+	const bool rebasing = m_settings.rebasing;
+	const bool detectGlitches = m_settings.glitchCorrection && !rebasing;
+	uint64_t rebases = 0;
+
+	#pragma omp parallel for schedule(dynamic, 256) reduction(+:rebases)
+	for (int i = 0; i < (int)pixels.size(); ++i)
+	{
+		const unsigned pixelIndex = pixels[i];
+		const int image_x = pixelIndex % m_width;
+		const int image_y = pixelIndex / m_width;
+
+		const T dcx = T(image_x - referenceX) * step;
+		const T dcy = T(image_y - referenceY) * step;
+
+		// z(1) = c, hence dz(1) = dc, unless the series already
+		// brought us further along the orbit
+		T dzx = dcx;
+		T dzy = dcy;
+		unsigned n = startIteration;
+
+		if (n > 1)
+		{
+			SeriesApproximation::complex dz = m_series.evaluate(SeriesApproximation::complex(dcx, dcy));
+			dzx = floatexp_cast<T>(dz.x);
+			dzy = floatexp_cast<T>(dz.y);
+		}
+
+		double glitchDepth = -1.0;
+
+		int count;
+		for (count = (int)n - 1; count < resolution; ++count)
+		{
+			// z is back in double range whatever the size of dz
+			const double zx = Z[n].x + toDouble(dzx);
+			const double zy = Z[n].y + toDouble(dzy);
+			const double zNorm = zx * zx + zy * zy;
+
+			if (zNorm > 4.0)
+				break;
+
+			if (rebasing && (zNorm < toDouble(dzx * dzx + dzy * dzy) || n == lastIteration))
+			{
+				// Z(0) = 0: carry on from the start of the reference
+				// with the full value of z as offset
+				dzx = zx;
+				dzy = zy;
+				n = 0;
+				++rebases;
+			}
+			else if (detectGlitches)
+			{
+				const double referenceNorm = Z[n].x * Z[n].x + Z[n].y * Z[n].y;
+
+				if (zNorm < glitchTolerance * referenceNorm)
+				{
+					glitchDepth = zNorm / referenceNorm;
+					break;
+				}
+			}
+
+			if (n == lastIteration)
+			{
+				// Reference and pixel both made it to the last iteration.
+				// Without rebasing n is always count + 1.
+				if (!Z.hasEscaped())
+				{
+					count = resolution;
+					break;
+				}
+
+				if (detectGlitches)
+				{
+					glitchDepth = referenceEscaped;
+					break;
+				}
+
+				// The reference escaped before this pixel did, there is
+				// no Z(n+1) left to perturb: finish in plain double
+				double px = zx;
+				double py = zy;
+				const double pcx = center.x + toDouble(dcx);
+				const double pcy = center.y + toDouble(dcy);
+
+				for (; count < resolution; ++count)
+				{
+					const double x2 = px * px;
+					const double y2 = py * py;
+
+					if (x2 + y2 > 4.0)
+						break;
+
+					py = 2.0 * px * py + pcy;
+					px = x2 - y2 + pcx;
+				}
+				break;
+			}
+
+			if (useBLA)
+			{
+				// Never jump over the last iteration, its escape test
+				// decides whether the pixel belongs to the set
+				const BLAStep* bla = m_bla.lookup(n, dzx * dzx + dzy * dzy, resolution - 1 - count);
+
+				if (bla)
+				{
+					const floatexp tx = bla->ax * dzx - bla->ay * dzy + bla->bx * dcx - bla->by * dcy;
+					const floatexp ty = bla->ax * dzy + bla->ay * dzx + bla->bx * dcy + bla->by * dcx;
+					dzx = floatexp_cast<T>(tx);
+					dzy = floatexp_cast<T>(ty);
+					n += bla->length;
+					count += bla->length - 1;
+					continue;
+				}
+			}
+
+			const T tx = 2.0 * (Z[n].x * dzx - Z[n].y * dzy) + dzx * dzx - dzy * dzy + dcx;
+			const T ty = 2.0 * (Z[n].x * dzy + Z[n].y * dzx) + 2.0 * dzx * dzy + dcy;
+			dzx = tx;
+			dzy = ty;
+			++n;
+		}
+
+		m_glitchDepth[pixelIndex] = glitchDepth;
+
+		setEscapeColor(m_pixelBuffer + pixelIndex * 4, count, resolution);
+	}
+
+	m_statistics.rebases += rebases;
+
+	for (size_t i = 0; i < pixels.size(); ++i)
+	{
+		if (m_glitchDepth[pixels[i]] >= 0.0)
+			glitches.push_back(pixels[i]);
+	}
+}
+
+floatexp MandelbrotRendererPerturbation::_frameRadius(int referenceX, int referenceY) const
+{
+	const floatexp dx = m_step * std::max(referenceX, (int)m_width - 1 - referenceX);
+	const floatexp dy = m_step * std::max(referenceY, (int)m_heigth - 1 - referenceY);
+
+	return sqrt(dx * dx + dy * dy);
+}
+
+#endif
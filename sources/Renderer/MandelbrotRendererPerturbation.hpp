@@ -0,0 +1,128 @@
+/*
+ *  MandelbrotRendererPerturbation.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef MANDELBROT_RENDERER_PERTURBATION_HPP
+#define MANDELBROT_RENDERER_PERTURBATION_HPP
+
+#ifdef OMP_BUILD
+
+#include "IRenderer.hpp"
+#include "ReferenceOrbit.hpp"
+#include "CoordinateGenerator.hpp"
+#include "SeriesApproximation.hpp"
+#include "BilinearApproximation.hpp"
+#include "../Real/floatexp.hpp"
+
+struct PerturbationSettings
+{
+	PerturbationSettings() :
+	seriesApproximation(true),
+	seriesTerms(16),
+	bilinearApproximation(false),
+	glitchCorrection(true),
+	maxReferences(32),
+	rebasing(false)
+	{
+	}
+
+	// Skip the iterations common to the whole frame with a power series
+	bool seriesApproximation;
+	unsigned seriesTerms;
+
+	// Let each pixel jump over many iterations at once from any
+	// iteration, with a table of merged linear steps
+	bool bilinearApproximation;
+
+	// Detect glitched pixels and render them again around secondary
+	// references placed inside the glitches, up to maxReferences orbits
+	bool glitchCorrection;
+	unsigned maxReferences;
+
+	// Restart dz against the beginning of the reference whenever the
+	// pixel gets closer to 0 than to the reference (|Z + dz| < |dz|).
+	// A single orbit then serves the whole frame: glitch correction is
+	// not needed and is skipped.
+	bool rebasing;
+};
+
+// Deep zoom renderer: a single reference orbit is computed in mpf at the
+// center of the view, every pixel then iterates its double precision
+// offset dz from that orbit:
+//     dz(n+1) = 2 * Z(n) * dz(n) + dz(n)^2 + dc
+// Past the range of double (pixel spacing below ~1e-290) dc and dz are
+// iterated as floatexp instead.
+// Pixels whose orbit the reference cannot follow are rendered again
+// around new references, in as many passes as needed.
+class MandelbrotRendererPerturbation : public IRenderer {
+public:
+	MandelbrotRendererPerturbation(const PerturbationSettings& settings = PerturbationSettings());
+
+	virtual void render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
+					   mpfreal& zoom, int resolution, mpfreal& x, mpfreal& y);
+
+	// Render only the given pixels (indices into the frame of the given
+	// coordinates), the rest of the buffer is left untouched
+	void renderPixels(unsigned char *pixelBuffer, const CoordinateGenerator& coordinates, int resolution,
+					  const std::vector<unsigned>& pixels);
+
+	// Pixels still glitched once every reference was used
+	const std::vector<unsigned>& getUnresolvedGlitches() const { return m_unresolvedGlitches; }
+
+private:
+	// Iterate the given pixels around the current reference, which sits
+	// on pixel (referenceX, referenceY), and return the glitched ones
+	void _renderPixels(const std::vector<unsigned>& pixels, int referenceX, int referenceY,
+					   unsigned startIteration, std::vector<unsigned>& glitches);
+
+	// Same with dc and dz of type T, double or floatexp
+	template <typename T>
+	void _iteratePixels(const std::vector<unsigned>& pixels, int referenceX, int referenceY,
+						unsigned startIteration, std::vector<unsigned>& glitches);
+
+	// Largest |dc| of the frame seen from pixel (referenceX, referenceY)
+	floatexp _frameRadius(int referenceX, int referenceY) const;
+
+	PerturbationSettings m_settings;
+	CoordinateGenerator m_coordinates;
+
+	unsigned char* m_pixelBuffer;
+	unsigned m_width;
+	unsigned m_heigth;
+	int m_resolution;
+	floatexp m_step;
+
+	// Pauldelbrot ratio |Z + dz|^2 / |Z|^2 of every glitched pixel,
+	// negative for the others
+	std::vector<double> m_glitchDepth;
+	std::vector<unsigned> m_unresolvedGlitches;
+
+	ReferenceOrbit m_reference;
+	SeriesApproximation m_series;
+	BilinearApproximation m_bla;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ *  MandelbrotRendererQuadDouble.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "../Common.hpp"
+
+#ifdef OMP_BUILD
+
+#include "MandelbrotRendererQuadDouble.hpp"
+#include "EscapeTime.hpp"
+#include <vector>
+
+void MandelbrotRendererQuadDouble::render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
+	mpfreal& zoom, int resolution, mpfreal& x, mpfreal& y)
+{
+	m_coordinates.compute(width, heigth, zoom, x, y);
+
+	// Column and row coordinates, the only mpf work of the frame
+	std::vector<quaddouble> columns;
+	std::vector<quaddouble> rows;
+
+	m_coordinates.getColumns(columns);
+	m_coordinates.getRows(rows);
+
+	m_statistics = RenderStatistics();
+	m_statistics.interiorPixels = renderEscapeTime<EscapeTimeTraits<quaddouble> >(pixelBuffer, width, heigth, resolution,
+																				  columns, rows);
+}
+
+int MandelbrotRendererQuadDouble::iterate(const quaddouble& cx, const quaddouble& cy, int resolution)
+{
+	return escapeTime<EscapeTimeTraits<quaddouble> >(cx, cy, resolution);
+}
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ *  MandelbrotRendererQuadDouble.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef MANDELBROT_RENDERER_QUAD_DOUBLE_HPP
+#define MANDELBROT_RENDERER_QUAD_DOUBLE_HPP
+
+#ifdef OMP_BUILD
+
+#include "IRenderer.hpp"
+#include "CoordinateGenerator.hpp"
+#include "../Real/quaddouble.hpp"
+
+// Escape time renderer in quad-double (~212 bits), for the zooms between
+// 1e28 and about 1e60 that double-double cannot resolve, without the heap
+// traffic of mpf: a quad-double lives on the stack.
+class MandelbrotRendererQuadDouble : public IRenderer {
+public:
+	virtual void render(unsigned char *pixelBuffer, unsigned width, unsigned heigth,
+					   mpfreal& zoom, int resolution, mpfreal& x, mpfreal& y);
+
+	// Escape count of the pixel of coordinates (cx, cy)
+	static int iterate(const quaddouble& cx, const quaddouble& cy, int resolution);
+
+private:
+	CoordinateGenerator m_coordinates;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ *  ReferenceOrbit.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "ReferenceOrbit.hpp"
+
+ReferenceOrbit::ReferenceOrbit() :
+m_points(),
+m_cx(),
+m_cy(),
+m_escaped(false)
+{
+	m_center.x = 0;
+	m_center.y = 0;
+}
+
+void ReferenceOrbit::compute(const mpfreal& cx, const mpfreal& cy, unsigned maxIteration)
+{
+	m_cx = cx;
+	m_cy = cy;
+	m_center.x = mpf_get_d(*cx);
+	m_center.y = mpf_get_d(*cy);
+	m_escaped = false;
+
+	m_points.clear();
+	m_points.reserve(maxIteration + 1);
+
+	OrbitPoint origin = { 0.0, 0.0 };
+	m_points.push_back(origin);
+
+	mpfreal zx, zy;
+	mpfreal x2, y2;
+
+	zx = 0;
+	zy = 0;
+
+	for (unsigned n = 1; n <= maxIteration; ++n)
+	{
+		x2 = zx * zx;
+		y2 = zy * zy;
+		zy = mul2k(zx * zy, 1) + cy;
+		zx = x2 - y2 + cx;
+
+		OrbitPoint point;
+		point.x = mpf_get_d(*zx);
+		point.y = mpf_get_d(*zy);
+		m_points.push_back(point);
+
+		if (point.x * point.x + point.y * point.y > 4.0)
+		{
+			m_escaped = true;
+			break;
+		}
+	}
+}
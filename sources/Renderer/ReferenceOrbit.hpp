@@ -0,0 +1,68 @@
+/*
+ *  ReferenceOrbit.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef REFERENCE_ORBIT_HPP
+#define REFERENCE_ORBIT_HPP
+
+#include <vector>
+#include "../Real/mpfreal.hpp"
+
+struct OrbitPoint
+{
+	double x;
+	double y;
+};
+
+// Orbit Z(n+1) = Z(n)^2 + C of a single point, iterated in mpf
+// and rounded to double once per iteration. Z(0) = 0, so Z(1) = C.
+class ReferenceOrbit
+{
+public:
+	ReferenceOrbit();
+
+	// Iterate until Z escapes or maxIteration is reached.
+	void compute(const mpfreal& cx, const mpfreal& cy, unsigned maxIteration);
+
+	// Index of the last stored point. Either maxIteration or the
+	// first iteration where |Z| > 2.
+	unsigned getLastIteration() const { return unsigned(m_points.size()) - 1; }
+	bool hasEscaped() const { return m_escaped; }
+
+	const OrbitPoint& operator[](unsigned n) const { return m_points[n]; }
+
+	// C rounded to double, used when a pixel outlives the reference.
+	const OrbitPoint& getCenter() const { return m_center; }
+
+	const mpfreal& getCenterX() const { return m_cx; }
+	const mpfreal& getCenterY() const { return m_cy; }
+
+private:
+	std::vector<OrbitPoint> m_points;
+	OrbitPoint m_center;
+	mpfreal m_cx, m_cy;
+	bool m_escaped;
+};
+
+#endif
@@ -0,0 +1,113 @@
+/*
+ *  SeriesApproximation.cpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#include "SeriesApproximation.hpp"
+
+namespace {
+	// Largest relative error between the series and the probes, squared
+	const floatexp tolerance2 = 1e-24;
+
+	const floatexp escapeRadius2 = 4.0;
+}
+
+SeriesApproximation::SeriesApproximation(unsigned terms) :
+m_terms(terms < 1 ? 1 : terms),
+m_startIteration(1),
+m_radius(0),
+m_coefficients()
+{
+}
+
+void SeriesApproximation::compute(const ReferenceOrbit& orbit, const floatexp& radius,
+								  const std::vector<complex>& probes, unsigned maxIteration)
+{
+	m_radius = radius;
+	m_startIteration = 1;
+
+	// z(1) = c: dz(1) = dc, so A1 = 1 and every other term is 0
+	m_coefficients.assign(m_terms + 1, complex());
+	m_coefficients[1] = radius;
+
+	if (radius <= 0.0)
+		return;
+
+	std::vector<complex> next(m_terms + 1);
+	std::vector<complex> dz(probes);
+
+	unsigned lastIteration = orbit.getLastIteration();
+	if (lastIteration > maxIteration)
+		lastIteration = maxIteration;
+
+	for (unsigned n = 1; n < lastIteration; ++n)
+	{
+		const complex Z2(2.0 * orbit[n].x, 2.0 * orbit[n].y);
+
+		// A1(n+1) = 2 Z(n) A1(n) + 1
+		// Ak(n+1) = 2 Z(n) Ak(n) + sum(Aj(n) * Ak-j(n), j = 1..k-1)
+		for (unsigned k = 1; k <= m_terms; ++k)
+		{
+			complex sum = Z2 * m_coefficients[k];
+			for (unsigned j = 1; j < k; ++j)
+				sum += m_coefficients[j] * m_coefficients[k - j];
+			next[k] = sum;
+		}
+		next[1] += radius;
+
+		const complex Znext(orbit[n + 1].x, orbit[n + 1].y);
+		bool valid = true;
+
+		for (size_t i = 0; i < probes.size() && valid; ++i)
+		{
+			dz[i] = Z2 * dz[i] + dz[i] * dz[i] + probes[i];
+
+			if (norm(Znext + dz[i]) > escapeRadius2)
+				valid = false;
+			else if (norm(evaluate(next, probes[i] / radius) - dz[i]) > tolerance2 * norm(dz[i]))
+				valid = false;
+		}
+
+		if (!valid)
+			break;
+
+		m_coefficients.swap(next);
+		m_startIteration = n + 1;
+	}
+}
+
+SeriesApproximation::complex SeriesApproximation::evaluate(const complex& dc) const
+{
+	if (m_startIteration == 1)
+		return dc;
+
+	return evaluate(m_coefficients, dc / m_radius);
+}
+
+SeriesApproximation::complex SeriesApproximation::evaluate(const std::vector<complex>& coefficients, const complex& u)
+{
+	complex result;
+	for (size_t k = coefficients.size() - 1; k >= 1; --k)
+		result = (result + coefficients[k]) * u;
+	return result;
+}
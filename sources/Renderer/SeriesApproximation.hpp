@@ -0,0 +1,68 @@
+/*
+ *  SeriesApproximation.hpp
+ *	Mandelbrot Fractal Explorer Project - Copyright (c) 2012 Lucas Soltic & Maxime Griot
+ *
+ *  This software is provided 'as-is', without any express or
+ *  implied warranty. In no event will the authors be held
+ *  liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose,
+ *  including commercial applications, and to alter it and redistribute
+ *  it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented;
+ *  you must not claim that you wrote the original software.
+ *  If you use this software in a product, an acknowledgment
+ *  in the product documentation would be appreciated but
+ *  is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such,
+ *  and must not be misrepresented as being the original software.
+ *
+ *  3. This notice may not be removed or altered from any
+ *  source distribution.
+ */
+
+#ifndef SERIES_APPROXIMATION_HPP
+#define SERIES_APPROXIMATION_HPP
+
+#include <vector>
+#include "ReferenceOrbit.hpp"
+#include "../Real/floatexp.hpp"
+#include "../Real/Complex.hpp"
+
+// Truncated power series of the perturbation around a reference orbit:
+//     dz(n) = A1(n) * dc + A2(n) * dc^2 + ... + Ak(n) * dc^k
+// The coefficients are stored pre-multiplied by radius^k, radius being
+// the largest |dc| of the frame, and evaluated at dc / radius. They are
+// kept in floatexp: A1 alone reaches radius * 2^n long before the
+// reference escapes, way past 1e-308 at deep zooms.
+class SeriesApproximation
+{
+public:
+	typedef Complex<floatexp> complex;
+
+	SeriesApproximation(unsigned terms = 16);
+
+	// Advance the series along the orbit for as long as it agrees with
+	// plain perturbation at every probe (given as dc offsets).
+	void compute(const ReferenceOrbit& orbit, const floatexp& radius,
+				 const std::vector<complex>& probes, unsigned maxIteration);
+
+	// First iteration that still has to be computed per pixel
+	unsigned getStartIteration() const { return m_startIteration; }
+	unsigned getSkippedIterations() const { return m_startIteration - 1; }
+
+	// dz at the start iteration for a pixel offset dc
+	complex evaluate(const complex& dc) const;
+
+private:
+	static complex evaluate(const std::vector<complex>& coefficients, const complex& u);
+
+	unsigned m_terms;
+	unsigned m_startIteration;
+	floatexp m_radius;
+	std::vector<complex> m_coefficients;
+};
+
+#endif
@@ -27,6 +27,8 @@
 
 #include <SFML/Graphics.hpp>
 #include "Application.hpp"
+#include "Benchmark.hpp"
+#include "Real/mpfarena.hpp"
 #include <mpir/gmp.h>
 #include <vector>
 #include <string>
@@ -34,7 +36,20 @@
 
 int main(int argc, char** argv)
 {
-	mpf_set_default_prec(512);
+	mpfarena::install();
+
+	// -b conf1.ml conf2.ml ...: benchmark the saved locations, no window
+	if (argc > 2 && std::string(argv[1]) == "-b")
+	{
+		Benchmark benchmark(1280, 720);
+		
+		for (int i = 2; i < argc; ++i)
+			benchmark.run(argv[i]);
+		
+		benchmark.runFixedPointOperations();
+		
+		return 0;
+	}
 
 	sf::RenderWindow window(sf::VideoMode::getDesktopMode(), "Mandelbrot Fractal Explorer", sf::Style::Default);
 	window.setFramerateLimit(60);